@@ -0,0 +1,121 @@
+#pragma once
+
+#include <groov/config.hpp>
+
+#include <async/concepts.hpp>
+#include <async/sequence.hpp>
+
+#include <stdx/bit.hpp>
+#include <stdx/static_assert.hpp>
+
+#include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/list.hpp>
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace groov {
+namespace attr {
+// How a partial write of several bits to a register with aliases is made:
+// with a read-modify-write of the register, as for any other register, or
+// with a store to each alias. The stores need no load, but between them the
+// register holds neither its old value nor its new one, and two writers of
+// the register can interleave their stores and leave a mix of both values.
+enum struct multi_bit_writes { rmw, split };
+
+// A register with this attribute has alias registers at the given byte
+// offsets from its address: writing ones to the set alias sets the
+// corresponding bits of the register, and writing ones to the clear alias
+// clears them. Zeros written to either alias have no effect.
+template <std::size_t SetOffset, std::size_t ClearOffset,
+          multi_bit_writes MultiBit = multi_bit_writes::rmw>
+struct set_clear_aliases {
+    using is_register_attribute = void;
+    constexpr static auto set_offset = SetOffset;
+    constexpr static auto clear_offset = ClearOffset;
+    constexpr static auto multi_bit = MultiBit;
+};
+} // namespace attr
+
+namespace detail {
+template <typename A>
+using is_set_clear_aliases = std::bool_constant<requires {
+    A::set_offset;
+    A::clear_offset;
+}>;
+
+template <typename R>
+using set_clear_aliases_of =
+    boost::mp11::mp_copy_if<typename R::attributes_t, is_set_clear_aliases>;
+
+template <typename R>
+concept aliased_register = requires { typename R::attributes_t; } and
+                           not boost::mp11::mp_empty<
+                               set_clear_aliases_of<R>>::value;
+
+template <typename R>
+using set_clear_aliases_t = boost::mp11::mp_front<set_clear_aliases_of<R>>;
+
+// A partial write goes through the aliases if it changes a single bit, or if
+// the register opts in to splitting writes of several bits.
+template <typename R, auto Mask>
+constexpr auto writes_through_aliases = [] {
+    if constexpr (aliased_register<R>) {
+        return std::has_single_bit(Mask) or
+               set_clear_aliases_t<R>::multi_bit ==
+                   attr::multi_bit_writes::split;
+    } else {
+        return false;
+    }
+}();
+
+template <typename Register> constexpr auto alias_address(std::size_t offset) {
+    auto const addr = get_address<Register>();
+    using addr_t = decltype(addr);
+    if constexpr (std::is_pointer_v<addr_t>) {
+        return stdx::bit_cast<addr_t>(stdx::bit_cast<std::uintptr_t>(addr) +
+                                      offset);
+    } else if constexpr (std::integral<addr_t>) {
+        return static_cast<addr_t>(addr + offset);
+    } else {
+        STATIC_ASSERT(std::integral<addr_t>,
+                      "Register {} with alias registers must have an integral "
+                      "or pointer address",
+                      Register::name);
+        return addr;
+    }
+}
+
+// Write the bits in Mask with plain stores to the alias registers instead of
+// a read-modify-write. The bus sees a fully-covered write: the other bits are
+// written as zeros, which the aliases ignore.
+//
+// A split write of several bits takes two stores, to the clear alias and then
+// to the set alias. Between them the register holds its old value with the
+// bits to be cleared already cleared, and none of the bits to be set yet set.
+template <typename Register, typename Bus, auto Mask>
+auto write_aliased(decltype(Mask) value) -> async::sender auto {
+    using T = decltype(Mask);
+    using A = set_clear_aliases_t<Register>;
+    constexpr auto id_mask = static_cast<T>(~Mask);
+
+    if constexpr (std::has_single_bit(Mask)) {
+        auto const offset =
+            (value & Mask) != T{} ? A::set_offset : A::clear_offset;
+        return Bus::template write<Register::name, Mask, id_mask, T{}>(
+            alias_address<Register>(offset), Mask);
+    } else {
+        return Bus::template write<Register::name, Mask, id_mask, T{}>(
+                   alias_address<Register>(A::clear_offset),
+                   static_cast<T>(~value & Mask)) |
+               async::seq(
+                   Bus::template write<Register::name, Mask, id_mask, T{}>(
+                       alias_address<Register>(A::set_offset),
+                       static_cast<T>(value & Mask)));
+    }
+}
+} // namespace detail
+} // namespace groov
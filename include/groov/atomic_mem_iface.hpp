@@ -0,0 +1,55 @@
+#pragma once
+
+#include <async/concepts.hpp>
+#include <async/just_result_of.hpp>
+#include <async/then.hpp>
+
+#include <stdx/bit.hpp>
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+namespace groov {
+// A HardwareInterface for memory shared between threads. Every access is
+// atomic, and read-modify-write is done in one atomic operation, so that
+// concurrent writes to different fields of a register are not lost.
+struct atomic_mem_iface {
+    template <std::unsigned_integral T>
+    static auto store(std::uintptr_t iaddr) {
+        return async::then([=](T value) -> void {
+            std::atomic_ref<T>{*stdx::bit_cast<T *>(iaddr)}.store(value);
+        });
+    }
+
+    template <std::unsigned_integral T>
+    static auto load(std::uintptr_t iaddr) -> async::sender auto {
+        return async::just_result_of([=]() -> T {
+            return std::atomic_ref<T>{*stdx::bit_cast<T *>(iaddr)}.load();
+        });
+    }
+
+    // Replace the bits not in keep with bits (which has no bits in keep).
+    template <std::unsigned_integral T>
+    static auto modify(std::uintptr_t iaddr, T keep) {
+        return async::then([=](T bits) -> void {
+            auto ref = std::atomic_ref<T>{*stdx::bit_cast<T *>(iaddr)};
+            if (bits == static_cast<T>(~keep)) {
+                ref.fetch_or(bits);
+            } else if (bits == T{}) {
+                ref.fetch_and(keep);
+            } else {
+                auto old = ref.load();
+                while (not ref.compare_exchange_weak(
+                    old, static_cast<T>((old & keep) | bits))) {
+                }
+            }
+        });
+    }
+
+    template <typename T>
+    constexpr static std::size_t alignment =
+        std::atomic_ref<T>::required_alignment;
+};
+} // namespace groov
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace groov {
+// Extract field F from each of an array of register values (e.g. a snapshot
+// of every element of a register array). The first min(src.size(),
+// dst.size()) values are converted, and the number converted is returned.
+// This is a convenience over looping on F::extract: it is no faster.
+template <typename F, typename RegType, std::size_t N, std::size_t M>
+    requires std::unsigned_integral<std::remove_const_t<RegType>>
+constexpr auto extract_all(std::span<RegType, N> src,
+                           std::span<typename F::type_t, M> dst)
+    -> std::size_t {
+    using T = std::remove_const_t<RegType>;
+    auto const n = std::min(src.size(), dst.size());
+    for (auto i = std::size_t{}; i < n; ++i) {
+        dst[i] = F::template extract<T>(src[i]);
+    }
+    return n;
+}
+
+// Insert a value of field F into each of an array of register values, leaving
+// their other bits alone. As with extract_all, the number of values converted
+// is returned.
+template <typename F, std::unsigned_integral RegType, std::size_t N,
+          typename T, std::size_t M>
+    requires std::same_as<std::remove_const_t<T>, typename F::type_t>
+constexpr auto insert_all(std::span<RegType, N> dst, std::span<T, M> src)
+    -> std::size_t {
+    auto const n = std::min(src.size(), dst.size());
+    for (auto i = std::size_t{}; i < n; ++i) {
+        F::template insert<RegType>(dst[i], src[i]);
+    }
+    return n;
+}
+} // namespace groov
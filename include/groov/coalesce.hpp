@@ -0,0 +1,197 @@
+#pragma once
+
+#include <groov/config.hpp>
+
+#include <boost/mp11/list.hpp>
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace groov::detail {
+template <std::size_t N> struct uint_of_size;
+template <> struct uint_of_size<1> {
+    using type = std::uint8_t;
+};
+template <> struct uint_of_size<2> {
+    using type = std::uint16_t;
+};
+template <> struct uint_of_size<4> {
+    using type = std::uint32_t;
+};
+template <> struct uint_of_size<8> {
+    using type = std::uint64_t;
+};
+template <std::size_t N> using uint_of_size_t = typename uint_of_size<N>::type;
+
+template <typename R>
+concept constant_addressed = std::integral<typename R::address_t>;
+
+template <typename R> constexpr auto constant_address() -> std::uintptr_t {
+    if constexpr (constant_addressed<R>) {
+        return static_cast<std::uintptr_t>(get_address<R>());
+    } else {
+        return {};
+    }
+}
+
+template <typename Bus>
+consteval auto can_coalesce_size(std::size_t size, std::uintptr_t addr)
+    -> bool {
+    if constexpr (std::endian::native != std::endian::little and
+                  std::endian::native != std::endian::big) {
+        return false;
+    } else {
+        switch (size) {
+        case sizeof(std::uint16_t):
+            return can_coalesce<Bus, std::uint16_t>(addr);
+        case sizeof(std::uint32_t):
+            return can_coalesce<Bus, std::uint32_t>(addr);
+        case sizeof(std::uint64_t):
+            return can_coalesce<Bus, std::uint64_t>(addr);
+        default:
+            return false;
+        }
+    }
+}
+
+// A plan groups register accesses into runs. Each run is either a single
+// access, or several accesses to contiguous registers that the bus can perform
+// with one wide access. Accesses are described by types exposing register_t,
+// address and coalescable.
+template <std::size_t N> struct coalesce_plan {
+    std::array<std::size_t, N> order{};
+    std::array<std::size_t, N> first{};
+    std::array<std::size_t, N> length{};
+    std::size_t num_runs{};
+
+    [[nodiscard]] constexpr auto run_of(std::size_t access) const
+        -> std::size_t {
+        for (auto r = std::size_t{}; r < num_runs; ++r) {
+            for (auto i = first[r]; i < first[r] + length[r]; ++i) {
+                if (order[i] == access) {
+                    return r;
+                }
+            }
+        }
+        return num_runs;
+    }
+};
+
+template <typename Bus, typename... As>
+consteval auto plan_coalesce(boost::mp11::mp_list<As...>) {
+    constexpr auto N = sizeof...(As);
+    constexpr auto max_width = sizeof(std::uint64_t);
+
+    std::array<bool, N> const coalescable{As::coalescable...};
+    std::array<std::uintptr_t, N> const addrs{As::address...};
+    std::array<std::size_t, N> const sizes{
+        sizeof(typename As::register_t::type_t)...};
+
+    // coalescable accesses sorted by address, then the rest in their
+    // original order
+    auto const before = [&](std::size_t i, std::size_t j) {
+        if (coalescable[i] != coalescable[j]) {
+            return coalescable[i];
+        }
+        return coalescable[i] and addrs[i] < addrs[j];
+    };
+    std::array<std::size_t, N> sorted{};
+    for (auto i = std::size_t{}; i < N; ++i) {
+        auto j = i;
+        for (; j > 0 and before(i, sorted[j - 1]); --j) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = i;
+    }
+
+    // greedily take the widest run that the bus will accept at each point
+    std::array<std::size_t, N> starts{};
+    std::array<std::size_t, N> lengths{};
+    auto num_runs = std::size_t{};
+    for (auto i = std::size_t{}; i < N;) {
+        auto len = std::size_t{1};
+        if (coalescable[sorted[i]]) {
+            auto const base = addrs[sorted[i]];
+            auto width = sizes[sorted[i]];
+            for (auto j = i + 1; j < N and coalescable[sorted[j]] and
+                                 addrs[sorted[j]] == base + width;
+                 ++j) {
+                width += sizes[sorted[j]];
+                if (width > max_width) {
+                    break;
+                }
+                if (can_coalesce_size<Bus>(width, base)) {
+                    len = j - i + 1;
+                }
+            }
+        }
+        starts[num_runs] = i;
+        lengths[num_runs] = len;
+        ++num_runs;
+        i += len;
+    }
+
+    // emit runs in the order of their earliest access, so that a plan with
+    // no coalescing preserves the original order
+    auto const key = [&](std::size_t run) {
+        auto k = N;
+        for (auto i = starts[run]; i < starts[run] + lengths[run]; ++i) {
+            k = sorted[i] < k ? sorted[i] : k;
+        }
+        return k;
+    };
+    std::array<std::size_t, N> runs{};
+    for (auto r = std::size_t{}; r < num_runs; ++r) {
+        auto j = r;
+        for (; j > 0 and key(r) < key(runs[j - 1]); --j) {
+            runs[j] = runs[j - 1];
+        }
+        runs[j] = r;
+    }
+
+    coalesce_plan<N> p{};
+    auto pos = std::size_t{};
+    for (auto r = std::size_t{}; r < num_runs; ++r) {
+        p.first[r] = pos;
+        p.length[r] = lengths[runs[r]];
+        for (auto i = std::size_t{}; i < p.length[r]; ++i) {
+            p.order[pos++] = sorted[starts[runs[r]] + i];
+        }
+    }
+    p.num_runs = num_runs;
+    return p;
+}
+
+template <typename... As>
+using coalesced_t =
+    uint_of_size_t<(0u + ... + sizeof(typename As::register_t::type_t))>;
+
+// the bit position of a register's value inside a wide access at Base
+template <typename Wide, std::uintptr_t Base, typename A>
+constexpr auto lane_shift() -> std::size_t {
+    constexpr auto offset = A::address - Base;
+    if constexpr (std::endian::native == std::endian::little) {
+        return offset * 8u;
+    } else {
+        return (sizeof(Wide) - offset -
+                sizeof(typename A::register_t::type_t)) *
+               8u;
+    }
+}
+
+template <typename Wide, std::uintptr_t Base, typename A, typename T>
+constexpr auto to_lane(T value) -> Wide {
+    return static_cast<Wide>(static_cast<Wide>(value)
+                             << lane_shift<Wide, Base, A>());
+}
+
+template <typename Wide, std::uintptr_t Base, typename A>
+constexpr auto from_lane(Wide value) -> typename A::register_t::type_t {
+    return static_cast<typename A::register_t::type_t>(
+        value >> lane_shift<Wide, Base, A>());
+}
+} // namespace groov::detail
@@ -3,6 +3,7 @@
 #include <groov/boost_extra.hpp>
 #include <groov/identity.hpp>
 #include <groov/make_spec.hpp>
+#include <groov/plan.hpp>
 #include <groov/resolve.hpp>
 
 #include <async/concepts.hpp>
@@ -17,10 +18,13 @@
 #include <boost/mp11/list.hpp>
 #include <boost/mp11/set.hpp>
 
+#include <cassert>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <limits>
+#include <string_view>
 #include <type_traits>
 
 #ifndef ENABLE_GROOV_TEST
@@ -147,16 +151,44 @@ template <typename R> constexpr auto get_address() {
     return detail::maybe_invoke(R::address);
 }
 
+// Registers may be given attributes alongside their fields, to opt in to
+// behaviour that the bus or the read/write planning should know about.
+template <typename T>
+concept register_attribute = requires { typename T::is_register_attribute; };
+
+namespace detail {
+template <typename T>
+using is_register_attribute = std::bool_constant<register_attribute<T>>;
+
+template <stdx::ct_string Name, std::unsigned_integral T, typename WriteFn>
+struct reg_field_q {
+    template <typename... Fields>
+    using fn = field<Name, T, std::numeric_limits<T>::digits - 1, 0u, WriteFn,
+                     Fields...>;
+};
+
+template <stdx::ct_string Name, std::unsigned_integral T, typename WriteFn,
+          typename... Ts>
+using reg_field_t = boost::mp11::mp_apply_q<
+    reg_field_q<Name, T, WriteFn>,
+    boost::mp11::mp_remove_if<boost::mp11::mp_list<Ts...>,
+                              is_register_attribute>>;
+} // namespace detail
+
 template <stdx::ct_string Name, std::unsigned_integral T, auto Address,
-          write_function WriteFn = w::replace, fieldlike... Fields>
-struct reg : field<Name, T, std::numeric_limits<T>::digits - 1, 0u, WriteFn,
-                   Fields...> {
+          write_function WriteFn = w::replace, typename... Ts>
+    requires(... and (fieldlike<Ts> or register_attribute<Ts>))
+struct reg : detail::reg_field_t<Name, T, WriteFn, Ts...> {
     using address_t = decltype(detail::maybe_invoke(Address));
     constexpr static auto address = Address;
 
+    using attributes_t =
+        boost::mp11::mp_copy_if<boost::mp11::mp_list<Ts...>,
+                                detail::is_register_attribute>;
+
     constexpr static auto children_mask =
-        field<Name, T, std::numeric_limits<T>::digits - 1, 0u, WriteFn,
-              Fields...>::template children_mask<T>;
+        detail::reg_field_t<Name, T, WriteFn,
+                            Ts...>::template children_mask<T>;
 
     constexpr static T unused_mask =
         identity_write_function<WriteFn>
@@ -180,10 +212,94 @@ struct reg : field<Name, T, std::numeric_limits<T>::digits - 1, 0u, WriteFn,
     }
 };
 
+// N registers with the layout of Reg, Stride bytes apart from Reg's address.
+// Paths name the array, and an element is chosen at runtime by indexing the
+// path: grp / "CH"_r[i]. Every element shares the same masks and plans.
+template <stdx::ct_string Name, std::size_t N, std::size_t Stride,
+          typename Reg>
+    requires(boost::mp11::mp_empty<typename Reg::attributes_t>::value and
+             Stride >= sizeof(typename Reg::type_t))
+struct reg_array : Reg {
+    constexpr static auto name = Name;
+    constexpr static auto size = N;
+    constexpr static auto stride = Stride;
+
+    template <pathlike P> constexpr static auto resolve(P p) {
+        return detail::recursive_resolve<reg_array>(p);
+    }
+};
+
+template <typename T>
+concept register_array = requires {
+    { T::size } -> std::convertible_to<std::size_t>;
+    { T::stride } -> std::convertible_to<std::size_t>;
+};
+
+namespace detail {
+// the address of element i of a register array; any other register has just
+// the one address
+template <typename R>
+auto element_address(std::size_t i) -> typename R::address_t {
+    using A = typename R::address_t;
+    if constexpr (register_array<R>) {
+        assert(i < R::size);
+        auto const offset = i * R::stride;
+        if constexpr (std::is_pointer_v<A>) {
+            return stdx::bit_cast<A>(
+                stdx::bit_cast<std::uintptr_t>(get_address<R>()) + offset);
+        } else {
+            return static_cast<A>(get_address<R>() + offset);
+        }
+    } else {
+        return get_address<R>();
+    }
+}
+} // namespace detail
+
+template <typename R, typename Attribute>
+constexpr auto has_attribute = [] {
+    if constexpr (requires { typename R::attributes_t; }) {
+        return boost::mp11::mp_contains<typename R::attributes_t,
+                                        Attribute>::value;
+    } else {
+        return false;
+    }
+}();
+
+namespace detail {
+template <typename Obj> struct all_nodes;
+template <typename Obj> using all_nodes_t = typename all_nodes<Obj>::type;
+
+template <typename Obj> struct all_nodes {
+    using type = boost::mp11::mp_push_front<
+        boost::mp11::mp_flatten<
+            boost::mp11::mp_transform<all_nodes_t, typename Obj::children_t>>,
+        Obj>;
+};
+
+template <typename R>
+using read_effects_t = boost::mp11::mp_copy_if<all_nodes_t<R>, has_read_effect>;
+} // namespace detail
+
+// A register that has side effects on read, or has fields that do (see
+// r::clear_on_read and r::pop), is only read when asked for and never cached.
+template <typename R>
+constexpr auto has_read_effects =
+    not boost::mp11::mp_empty<detail::read_effects_t<R>>::value;
+
 template <typename Reg> struct reg_with_value : Reg {
     typename Reg::type_t value;
 };
 
+namespace detail {
+template <typename R> struct unwrap_register {
+    using type = R;
+};
+template <typename R> struct unwrap_register<reg_with_value<R>> {
+    using type = R;
+};
+} // namespace detail
+
 template <typename T>
 concept registerlike = fieldlike<T> and requires {
     typename T::address_t;
@@ -202,6 +318,103 @@ concept bus_for = requires(typename Reg::type_t data) {
     } -> async::sender;
 };
 
+namespace detail {
+template <typename P> constexpr auto unindexed(P const &p) -> decltype(auto) {
+    if constexpr (indexed_pathlike<P>) {
+        return (p.path);
+    } else {
+        return (p);
+    }
+}
+
+// The element that the indexed paths passed to a group choose: they must all
+// choose the same one.
+template <typename... Ps>
+constexpr auto common_index(Ps const &...ps) -> std::size_t {
+    auto index = std::size_t{};
+    auto found = false;
+    (
+        [&] {
+            if constexpr (indexed_pathlike<Ps>) {
+                assert(not found or ps.index == index);
+                index = ps.index;
+                found = true;
+            }
+        }(),
+        ...);
+    return index;
+}
+
+template <typename P> struct unindexed_path {
+    using type = get_path_t<P>;
+};
+template <typename P> struct unindexed_path<indexed<P>> {
+    using type = get_path_t<P>;
+};
+template <typename P>
+using unindexed_path_t = typename unindexed_path<P>::type;
+
+template <typename Group> struct names_register_array_q {
+    template <typename P>
+    using fn = std::bool_constant<
+        register_array<get_child<Group, root(unindexed_path_t<P>{})>>>;
+};
+
+template <typename P>
+using is_indexed_path = std::bool_constant<indexed_pathlike<P>>;
+
+// Every path to a register array passed to a group must be indexed, and
+// every indexed path must be to a register array.
+template <typename Group, typename... Ps>
+constexpr auto check_indexed_paths() -> void {
+    using L = boost::mp11::mp_list<Ps...>;
+    using arrays_t =
+        boost::mp11::mp_copy_if_q<L, names_register_array_q<Group>>;
+    using unindexed_t = boost::mp11::mp_remove_if<arrays_t, is_indexed_path>;
+    constexpr auto all_indexed = boost::mp11::mp_empty<unindexed_t>::value;
+    if constexpr (not all_indexed) {
+        STATIC_ASSERT(
+            all_indexed,
+            "Path ({}) to a register array in group ({}) must be indexed",
+            unindexed_path_t<boost::mp11::mp_front<unindexed_t>>::to_string(),
+            Group::name);
+    }
+
+    using not_arrays_t =
+        boost::mp11::mp_remove_if_q<L, names_register_array_q<Group>>;
+    using misindexed_t =
+        boost::mp11::mp_copy_if<not_arrays_t, is_indexed_path>;
+    constexpr auto all_arrays = boost::mp11::mp_empty<misindexed_t>::value;
+    if constexpr (not all_arrays) {
+        STATIC_ASSERT(
+            all_arrays,
+            "Indexed path ({}) in group ({}) is not to a register array",
+            unindexed_path_t<boost::mp11::mp_front<misindexed_t>>::to_string(),
+            Group::name);
+    }
+}
+
+// The element of any register array in a spec. Only a spec with a path to a
+// register array holds an index; in any other it is always 0.
+template <bool HasArray> struct spec_index {
+    constexpr static std::size_t index = 0;
+};
+template <> struct spec_index<true> {
+    std::size_t index{};
+};
+
+template <typename Group, typename Paths>
+using spec_index_for = spec_index<not boost::mp11::mp_empty<
+    boost::mp11::mp_copy_if_q<Paths, names_register_array_q<Group>>>::value>;
+
+template <typename Spec>
+constexpr auto set_index(Spec &s, [[maybe_unused]] std::size_t i) -> void {
+    if constexpr (requires { s.index = i; }) {
+        s.index = i;
+    }
+}
+} // namespace detail
+
 template <stdx::ct_string Name, typename Bus, registerlike... Registers>
     requires(... and bus_for<Bus, Registers>)
 struct group : named_container<Name, Registers...> {
@@ -212,13 +425,28 @@ struct group : named_container<Name, Registers...> {
     }
 
     constexpr auto operator()(pathlike auto const &...ps) const {
+        detail::check_indexed_paths<group,
+                                    std::remove_cvref_t<decltype(ps)>...>();
         return make_spec(*this, ps...);
     }
 
+    template <typename... Ps>
+        requires(... and (pathlike<Ps> or indexed_pathlike<Ps>)) and
+                (... or indexed_pathlike<Ps>)
+    constexpr auto operator()(Ps const &...ps) const {
+        detail::check_indexed_paths<group, Ps...>();
+        auto s = make_spec(*this, detail::unindexed(ps)...);
+        detail::set_index(s, detail::common_index(ps...));
+        return s;
+    }
+
   private:
     friend constexpr auto operator/(group g, pathlike auto const &p) {
         return g(p);
     }
+    friend constexpr auto operator/(group g, indexed_pathlike auto const &p) {
+        return g(p);
+    }
 };
 
 namespace detail {
@@ -353,4 +581,53 @@ consteval auto transform_mask(RegType mask) -> RegType {
         return std::numeric_limits<RegType>::max();
     }
 }
+
+template <typename Bus, std::unsigned_integral T>
+consteval auto can_coalesce(std::uintptr_t addr) -> bool {
+    if constexpr (requires {
+                      Bus::template can_coalesce<T>(std::uintptr_t{});
+                  }) {
+        return Bus::template can_coalesce<T>(addr);
+    } else {
+        return false;
+    }
+}
+
+// The accesses that Bus::write<Name, Mask, IdMask, IdValue>(addr) will make.
+// A bus may describe them itself with plan_write<Mask, IdMask>(name, addr);
+// otherwise the write is a single store of the whole register when its mask
+// covers the bus write width, and a read-modify-write when it does not.
+template <typename Bus, auto Mask, decltype(Mask) IdMask>
+consteval auto plan_write(std::string_view name, std::uintptr_t addr) {
+    if constexpr (requires {
+                      Bus::template plan_write<Mask, IdMask>(name, addr);
+                  }) {
+        return Bus::template plan_write<Mask, IdMask>(name, addr);
+    } else {
+        constexpr auto covered = transform_mask<Bus>(Mask) == (Mask | IdMask);
+        bus_plan<1> p{};
+        p.push_back({name, addr, sizeof(Mask),
+                     covered ? bus_access::store
+                             : bus_access::read_modify_write});
+        return p;
+    }
+}
+
+// Bus::write<Name, Mask, IdMask, IdValue>(addr, value) for Register. A bus
+// that needs more of the register than its name (e.g. to model the write
+// functions of its fields) may provide
+// write_register<Register, Mask, IdMask, IdValue>(addr, value) instead.
+template <typename Register, typename Bus, auto Mask, auto IdMask, auto IdValue>
+auto bus_write(auto addr, auto value) -> async::sender auto {
+    if constexpr (requires {
+                      Bus::template write_register<Register, Mask, IdMask,
+                                                   IdValue>(addr, value);
+                  }) {
+        return Bus::template write_register<Register, Mask, IdMask, IdValue>(
+            addr, value);
+    } else {
+        return Bus::template write<Register::name, Mask, IdMask, IdValue>(
+            addr, value);
+    }
+}
 } // namespace groov
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <groov/config.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+#include <async/let_value.hpp>
+#include <async/sync_wait.hpp>
+#include <async/then.hpp>
+#include <async/variant_sender.hpp>
+#include <async/when_all.hpp>
+
+#include <stdx/ct_string.hpp>
+#include <stdx/static_assert.hpp>
+
+#include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/list.hpp>
+
+#include <concepts>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+namespace groov {
+namespace attr {
+// A register with this attribute holds the same value from reset until the
+// next reset (an ID, version or capability register). It is read from the bus
+// once; after that, reads are answered from a cache.
+struct constant {
+    using is_register_attribute = void;
+};
+} // namespace attr
+
+namespace detail {
+template <typename R>
+concept constant_register = has_attribute<R, attr::constant>;
+
+template <typename R>
+using is_constant_register = std::bool_constant<constant_register<R>>;
+
+template <typename Bus, typename Register> struct constant_cache {
+    static inline typename Register::type_t value{};
+    static inline bool valid{};
+};
+
+template <typename Bus, typename Register>
+using constant_cache_t =
+    constant_cache<Bus, typename unwrap_register<Register>::type>;
+
+// what the bus sends for a read of Register: either the value, or an optional
+// value for a bus that can fail
+template <typename Bus, typename Register>
+using bus_read_t = std::remove_cvref_t<decltype(get<0>(
+    *(Bus::template read<Register::name, typename Register::type_t{}>(
+          get_address<Register>()) |
+      async::sync_wait())))>;
+
+template <typename Register> consteval auto check_constant() -> void {
+    STATIC_ASSERT(not has_read_effects<Register>,
+                  "Register {} is constant, but has side effects on read",
+                  Register::name);
+}
+
+// Reading a constant register always loads the whole register, so that the
+// cached value can answer a later read of any of its fields.
+template <typename Bus, typename Register>
+auto read_constant() -> async::sender auto {
+    check_constant<Register>();
+    using T = typename Register::type_t;
+    using V = bus_read_t<Bus, Register>;
+    using C = constant_cache_t<Bus, Register>;
+    constexpr auto mask = std::numeric_limits<T>::max();
+
+    // The cache is consulted when the read starts, not when the sender is
+    // made: the cache may be filled or reset in between.
+    return async::just() | async::let_value([] {
+               return async::make_variant_sender(
+                   C::valid, [] { return async::just(V{C::value}); },
+                   [] {
+                       return Bus::template read<Register::name, mask>(
+                                  get_address<Register>()) |
+                              async::then([](V value) -> V {
+                                  if constexpr (std::same_as<V, T>) {
+                                      C::value = value;
+                                      C::valid = true;
+                                  } else if (value) {
+                                      C::value = *value;
+                                      C::valid = true;
+                                  }
+                                  return value;
+                              });
+                   });
+           });
+}
+
+template <typename Group>
+using constant_registers_t =
+    boost::mp11::mp_copy_if<typename Group::children_t, is_constant_register>;
+} // namespace detail
+
+// Read every constant register in a group, so that later reads of them cause
+// no bus traffic.
+template <stdx::ct_string Name, typename Bus, typename... Registers>
+auto prime(group<Name, Bus, Registers...> const &) -> async::sender auto {
+    using G = group<Name, Bus, Registers...>;
+    return []<typename... Rs>(boost::mp11::mp_list<Rs...>) {
+        return async::when_all(
+                   detail::read_constant<typename G::bus_t, Rs>()...) |
+               async::then([](auto &&...) {});
+    }(detail::constant_registers_t<G>{});
+}
+
+// Forget the cached values of every constant register in a group: after the
+// device is reset, the next read of each goes to the bus again.
+template <stdx::ct_string Name, typename Bus, typename... Registers>
+auto reset_cache(group<Name, Bus, Registers...> const &) -> void {
+    using G = group<Name, Bus, Registers...>;
+    []<typename... Rs>(boost::mp11::mp_list<Rs...>) {
+        ((detail::constant_cache<typename G::bus_t, Rs>::valid = false),
+         ...);
+    }(detail::constant_registers_t<G>{});
+}
+} // namespace groov
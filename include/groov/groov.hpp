@@ -1,10 +1,21 @@
 #pragma once
 
+#include <groov/alias.hpp>
+#include <groov/atomic_mem_iface.hpp>
+#include <groov/bulk.hpp>
 #include <groov/config.hpp>
+#include <groov/constant.hpp>
+#include <groov/lazy_read.hpp>
 #include <groov/mmio_bus.hpp>
+#include <groov/modify.hpp>
 #include <groov/path.hpp>
+#include <groov/plan.hpp>
 #include <groov/read.hpp>
 #include <groov/read_spec.hpp>
+#include <groov/shadow.hpp>
+#include <groov/snapshot.hpp>
+#include <groov/tear_free.hpp>
 #include <groov/value_path.hpp>
+#include <groov/wait_until.hpp>
 #include <groov/write.hpp>
 #include <groov/write_spec.hpp>
@@ -4,6 +4,7 @@
 
 #include <concepts>
 #include <cstddef>
+#include <type_traits>
 
 namespace groov {
 template <typename T>
@@ -97,6 +98,21 @@ template <write_function T> struct write_only : T {
     using write_only_t = int;
 };
 
+// Read behaviours: a field or register whose write function is wrapped in one
+// of these has side effects when it is read, so groov never reads it unless
+// asked to, and never caches it.
+namespace r {
+// reading clears the value, e.g. a sticky status field
+template <write_function T> struct clear_on_read : T {
+    using read_effect_t = clear_on_read;
+};
+
+// reading consumes the value, e.g. a FIFO data register
+template <write_function T> struct pop : T {
+    using read_effect_t = pop;
+};
+} // namespace r
+
 template <typename T>
 concept read_only_write_function =
     identity_write_function<T> and requires { typename T::read_only_t; };
@@ -105,6 +121,10 @@ template <typename T>
 concept write_only_write_function =
     write_function<T> and requires { typename T::write_only_t; };
 
+template <typename T>
+concept read_effect_write_function =
+    write_function<T> and requires { typename T::read_effect_t; };
+
 template <typename T>
 using is_read_only =
     std::bool_constant<read_only_write_function<typename T::write_fn_t>>;
@@ -112,4 +132,8 @@ using is_read_only =
 template <typename T>
 using is_write_only =
     std::bool_constant<write_only_write_function<typename T::write_fn_t>>;
+
+template <typename T>
+using has_read_effect =
+    std::bool_constant<read_effect_write_function<typename T::write_fn_t>>;
 } // namespace groov
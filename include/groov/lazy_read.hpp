@@ -0,0 +1,131 @@
+#pragma once
+
+#include <groov/config.hpp>
+#include <groov/constant.hpp>
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/resolve.hpp>
+#include <groov/write_spec.hpp>
+
+#include <async/concepts.hpp>
+#include <async/sync_wait.hpp>
+
+#include <stdx/static_assert.hpp>
+#include <stdx/tuple.hpp>
+
+#include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/list.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+
+namespace groov {
+namespace detail {
+template <typename R>
+using optional_value_t = std::optional<typename R::type_t>;
+
+template <typename R, typename P, auto ReadMask>
+consteval auto check_lazy_path() -> void {
+    using F = resolve_t<R, P>;
+    using T = decltype(ReadMask);
+    STATIC_ASSERT((F::template mask<T> & ~ReadMask) == T{},
+                  "Path {} is not part of the lazy read",
+                  P::to_string());
+}
+} // namespace detail
+
+// The result of lazy_read: each register of the spec is read from the bus the
+// first time one of its fields is accessed, and remembered after that.
+template <typename Behavior, typename Group, typename Paths>
+class lazy_spec : detail::spec_index_for<Group, Paths> {
+    using spec_t = decltype(to_write_spec(read_spec<Group, Paths>{}));
+    using bus_t = typename Group::bus_t;
+    using registers_t =
+        boost::mp11::mp_rename<typename spec_t::value_t, boost::mp11::mp_list>;
+    using masks_t =
+        boost::mp11::mp_transform_q<detail::field_mask_for_reg_q<Paths>,
+                                    registers_t>;
+
+    boost::mp11::mp_apply<
+        stdx::tuple,
+        boost::mp11::mp_transform<detail::optional_value_t, registers_t>>
+        values{};
+
+    template <std::size_t I>
+    using read_sender_t = decltype(detail::read<
+                                   boost::mp11::mp_at_c<registers_t, I>,
+                                   Group, boost::mp11::mp_at_c<masks_t, I>>(
+        std::size_t{}));
+
+    template <std::size_t I> auto load() -> decltype(auto) {
+        auto &v = stdx::get<I>(values);
+        if (not v) {
+            using R = boost::mp11::mp_at_c<registers_t, I>;
+            using M = boost::mp11::mp_at_c<masks_t, I>;
+            auto s = detail::read<R, Group, M>(this->index);
+            static_assert(async::trivially_sync_waitable<decltype(s)> or
+                              std::is_same_v<Behavior, blocking>,
+                          "lazy_read() would block: if you really want this, "
+                          "use lazy_read<blocking>()");
+            if (auto r = std::move(s) | async::sync_wait()) {
+                v = get<0>(*r);
+            }
+        }
+        return (v);
+    }
+
+  public:
+    constexpr explicit lazy_spec([[maybe_unused]] std::size_t i) {
+        if constexpr (requires { this->index = i; }) {
+            this->index = i;
+        }
+    }
+
+    // Read the register holding P if it has not been read yet, and extract
+    // the value at P. For a bus whose reads may fail (whether it reads an
+    // optional value or may complete with an error), the value is optional,
+    // and a failed read is tried again at the next access.
+    template <pathlike P> auto operator[](P const &) {
+        using R = detail::path_register<spec_t, P>;
+        using Reg = typename R::type;
+        using F = resolve_t<Reg, P>;
+        detail::check_lazy_path<
+            Reg, P, boost::mp11::mp_at_c<masks_t, R::index>::value>();
+
+        auto const &v = load<R::index>();
+        using V = detail::bus_read_t<bus_t, Reg>;
+        if constexpr (std::is_same_v<V, typename Reg::type_t> and
+                      not detail::can_fail<read_sender_t<R::index>>) {
+            return F::extract(*v);
+        } else {
+            return v ? std::optional{F::extract(*v)} : std::nullopt;
+        }
+    }
+
+    // whether the register holding P has been read
+    template <pathlike P>
+    [[nodiscard]] auto is_loaded(P const &) const -> bool {
+        return stdx::get<detail::path_register<spec_t, P>::index>(values)
+            .has_value();
+    }
+};
+
+// Make a lazy_spec for a read_spec: nothing is read until a field is
+// accessed. Like sync_read, this is for buses whose reads complete
+// synchronously.
+template <typename Behavior = non_blocking, typename Group, typename Paths>
+[[nodiscard]] auto lazy_read(read_spec<Group, Paths> const &s)
+    -> lazy_spec<Behavior, Group, Paths> {
+    using Spec = decltype(to_write_spec(s));
+    using fields_per_reg_t = boost::mp11::mp_transform_q<
+        detail::fields_for_reg_q<Paths>, typename Spec::value_t>;
+    using field_masks_t = boost::mp11::mp_transform_q<
+        detail::field_mask_for_reg_q<Paths>, typename Spec::value_t>;
+    detail::check_write_only<
+        typename Spec::bus_t,
+        boost::mp11::mp_transform<detail::all_fields_t, fields_per_reg_t>,
+        field_masks_t>();
+    return lazy_spec<Behavior, Group, Paths>{s.index};
+}
+} // namespace groov
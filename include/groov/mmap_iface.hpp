@@ -0,0 +1,201 @@
+#pragma once
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+#include <async/just_result_of.hpp>
+#include <async/let_value.hpp>
+#include <async/variant_sender.hpp>
+
+#include <stdx/bit.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+namespace groov {
+// The error sent by an access through an mmap_iface whose mapping failed, or
+// that falls outside the register window.
+struct mmap_error {
+    int error{}; // the errno value from open or mmap, or EFAULT
+};
+
+namespace detail {
+template <typename Config>
+concept mmap_config = requires {
+    { Config::path } -> std::convertible_to<char const *>;
+    { Config::size } -> std::convertible_to<std::size_t>;
+};
+
+template <typename Config> constexpr auto mmap_offset() -> off_t {
+    if constexpr (requires { Config::offset; }) {
+        return static_cast<off_t>(Config::offset);
+    } else {
+        return {};
+    }
+}
+
+template <typename Config> constexpr auto mmap_base_address() -> std::uintptr_t {
+    if constexpr (requires { Config::base_address; }) {
+        return static_cast<std::uintptr_t>(Config::base_address);
+    } else {
+        return {};
+    }
+}
+
+template <typename Config> constexpr auto mmap_huge_page_size() -> std::size_t {
+    if constexpr (requires { Config::huge_page_size; }) {
+        return static_cast<std::size_t>(Config::huge_page_size);
+    } else {
+        return {};
+    }
+}
+
+// A shared, read-write mapping of part of a file. The file offset need not be
+// page-aligned: the mapping starts at the page boundary below it, and base is
+// the address that corresponds to the offset.
+class mapping {
+    void *addr{MAP_FAILED};
+    std::size_t length{};
+
+    auto try_map(int fd, off_t offset, std::size_t size, std::size_t page,
+                 int flags) -> bool {
+        auto const slack = static_cast<std::size_t>(offset) % page;
+        auto const len = (size + slack + page - 1) / page * page;
+        addr = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED | flags,
+                      fd, offset - static_cast<off_t>(slack));
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+        length = len;
+        base = stdx::bit_cast<std::uintptr_t>(addr) + slack;
+        return true;
+    }
+
+  public:
+    std::uintptr_t base{};
+    int error{};
+
+    mapping(char const *path, off_t offset, std::size_t size,
+            std::size_t huge_page_size) {
+        auto const fd = ::open(path, O_RDWR | O_SYNC | O_CLOEXEC);
+        if (fd < 0) {
+            error = errno;
+            return;
+        }
+
+        // huge pages are only an optimization: if the kernel or the file
+        // cannot provide them, fall back to normal pages
+        auto mapped = false;
+#ifdef MAP_HUGETLB
+        if (huge_page_size != 0) {
+            mapped = try_map(fd, offset, size, huge_page_size, MAP_HUGETLB);
+        }
+#endif
+        if (not mapped) {
+            auto const page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            mapped = try_map(fd, offset, size, page, 0);
+        }
+        if (not mapped) {
+            error = errno;
+        }
+        ::close(fd);
+    }
+
+    mapping(mapping const &) = delete;
+    mapping(mapping &&) = delete;
+    auto operator=(mapping const &) -> mapping & = delete;
+    auto operator=(mapping &&) -> mapping & = delete;
+
+    ~mapping() {
+        if (addr != MAP_FAILED) {
+            ::munmap(addr, length);
+        }
+    }
+
+    [[nodiscard]] auto ok() const -> bool { return addr != MAP_FAILED; }
+};
+} // namespace detail
+
+// A HardwareInterface for registers in a memory-mapped file, such as a UIO
+// device, /dev/mem, or a plain file for testing. Config provides:
+//  - path: the file to map
+//  - size: the size in bytes of the register window
+//  - offset (optional): the file offset of the window
+//  - base_address (optional): the register address at the start of the window
+//  - huge_page_size (optional): the huge page size to try to map with
+// Register addresses are relocated to base_address's position in the mapping.
+// The mapping is made on first use and lasts for the life of the program; if
+// it fails, every access completes with an mmap_error. So does an access that
+// is not wholly inside the window, with EFAULT.
+template <detail::mmap_config Config> struct mmap_iface {
+    static auto region() -> detail::mapping const & {
+        static detail::mapping const m{
+            Config::path, detail::mmap_offset<Config>(),
+            static_cast<std::size_t>(Config::size),
+            detail::mmap_huge_page_size<Config>()};
+        return m;
+    }
+
+    static auto mapped() -> bool { return region().ok(); }
+
+    template <std::unsigned_integral T>
+    static auto store(std::uintptr_t iaddr) {
+        return async::let_value([=](T value) {
+            auto const e = access_error<T>(iaddr);
+            auto const addr = address_of<T>(iaddr);
+            return async::make_variant_sender(
+                e == 0,
+                [=] {
+                    return async::just_result_of(
+                        [=]() -> void { *addr = value; });
+                },
+                [=] { return async::just_error(mmap_error{e}); });
+        });
+    }
+
+    template <std::unsigned_integral T>
+    static auto load(std::uintptr_t iaddr) -> async::sender auto {
+        auto const e = access_error<T>(iaddr);
+        auto const addr = address_of<T>(iaddr);
+        return async::make_variant_sender(
+            e == 0,
+            [=] { return async::just_result_of([=]() -> T { return *addr; }); },
+            [=] { return async::just_error(mmap_error{e}); });
+    }
+
+    template <typename T> constexpr static std::size_t alignment = alignof(T);
+
+  private:
+    // the offset into the window, which wraps for an address below it
+    static auto window_offset(std::uintptr_t iaddr) -> std::uintptr_t {
+        return iaddr - detail::mmap_base_address<Config>();
+    }
+
+    template <typename T>
+    static auto address_of(std::uintptr_t iaddr) -> T volatile * {
+        return stdx::bit_cast<T volatile *>(region().base +
+                                            window_offset(iaddr));
+    }
+
+    // the error an access of a T at iaddr sends, or 0 if it can go ahead
+    template <typename T>
+    static auto access_error(std::uintptr_t iaddr) -> int {
+        auto const &m = region();
+        if (not m.ok()) {
+            return m.error;
+        }
+        auto const offset = window_offset(iaddr);
+        auto const size = static_cast<std::uintptr_t>(Config::size);
+        if (offset > size or size - offset < sizeof(T)) {
+            return EFAULT;
+        }
+        return 0;
+    }
+};
+} // namespace groov
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <groov/identity.hpp>
+#include <groov/plan.hpp>
 
 #include <async/concepts.hpp>
 #include <async/just.hpp>
 #include <async/just_result_of.hpp>
 #include <async/then.hpp>
+#include <async/when_all.hpp>
 
 #include <stdx/bit.hpp>
 #include <stdx/ct_conversions.hpp>
@@ -15,10 +17,12 @@
 #include <boost/mp11/integral.hpp>
 #include <boost/mp11/list.hpp>
 
+#include <array>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <string_view>
 #include <type_traits>
 
 namespace groov {
@@ -82,6 +86,100 @@ template <auto Mask, decltype(Mask) IdMask> struct subword_satisfies {
     template <typename S> using fn = std::bool_constant<calculate<S>()>;
 };
 
+template <auto Mask, decltype(Mask) IdMask> struct subword_covered {
+    using base_type = decltype(Mask);
+
+    template <typename S>
+    using fn = std::bool_constant<((Mask | IdMask) &
+                                   S::template mask<base_type>) ==
+                                  S::template mask<base_type>>;
+};
+
+// A HardwareInterface may publish the relative cost of each width of access
+// with load_cost<T> and store_cost<T>. When it does, writes that no single
+// subword can satisfy may be done with several subword stores instead of a
+// read-modify-write, if that is cheaper.
+template <typename HardwareInterface>
+concept costed_interface = requires {
+    {
+        HardwareInterface::template load_cost<std::uint8_t>
+    } -> std::convertible_to<std::size_t>;
+    {
+        HardwareInterface::template store_cost<std::uint8_t>
+    } -> std::convertible_to<std::size_t>;
+};
+
+template <std::size_t N> struct subword_store_plan {
+    std::array<std::size_t, N> subwords{};
+    std::size_t num_stores{};
+    std::size_t cost{};
+    bool valid{};
+};
+
+// Find the cheapest set of disjoint subword stores that together write every
+// byte of Mask. Candidates are the subwords already known to be aligned, to
+// fit within the register and to be covered by Mask | IdMask.
+template <typename HardwareInterface, auto Mask, typename... Ss>
+consteval auto plan_subword_stores(mp_list<Ss...>) {
+    using base_type = decltype(Mask);
+    constexpr auto N = sizeof(base_type);
+    constexpr auto none = std::numeric_limits<std::size_t>::max();
+
+    constexpr std::array<std::size_t, sizeof...(Ss)> offsets{Ss::offset...};
+    constexpr std::array<std::size_t, sizeof...(Ss)> sizes{
+        sizeof(typename Ss::subword_t)...};
+    constexpr std::array<std::size_t, sizeof...(Ss)> costs{
+        static_cast<std::size_t>(
+            HardwareInterface::template store_cost<typename Ss::subword_t>)...};
+
+    // cost[b]: cheapest way to deal with bytes [0, b)
+    std::array<std::size_t, N + 1> cost{};
+    std::array<std::size_t, N + 1> from_byte{};
+    std::array<std::size_t, N + 1> from_subword{};
+    for (auto b = std::size_t{1}; b <= N; ++b) {
+        cost[b] = none;
+    }
+
+    for (auto b = std::size_t{}; b < N; ++b) {
+        if (cost[b] == none) {
+            continue;
+        }
+        auto const byte_mask = static_cast<base_type>(base_type{0xffu}
+                                                      << (b * 8u));
+        if ((Mask & byte_mask) == base_type{} and cost[b] < cost[b + 1]) {
+            cost[b + 1] = cost[b];
+            from_byte[b + 1] = b;
+            from_subword[b + 1] = none;
+        }
+        for (auto i = std::size_t{}; i < sizeof...(Ss); ++i) {
+            auto const end = b + sizes[i];
+            if (offsets[i] == b and cost[b] + costs[i] < cost[end]) {
+                cost[end] = cost[b] + costs[i];
+                from_byte[end] = b;
+                from_subword[end] = i;
+            }
+        }
+    }
+
+    subword_store_plan<N> p{};
+    if (cost[N] == none) {
+        return p;
+    }
+    p.valid = true;
+    p.cost = cost[N];
+    for (auto b = N; b > 0; b = from_byte[b]) {
+        if (from_subword[b] != none) {
+            p.subwords[p.num_stores++] = from_subword[b];
+        }
+    }
+    // the plan was built backwards: store in ascending address order
+    for (auto i = std::size_t{}; i < p.num_stores / 2; ++i) {
+        auto const tmp = p.subwords[i];
+        p.subwords[i] = p.subwords[p.num_stores - 1 - i];
+        p.subwords[p.num_stores - 1 - i] = tmp;
+    }
+    return p;
+}
 } // namespace detail
 
 struct cpp_mem_iface {
@@ -125,13 +223,59 @@ constexpr auto convert_addr(U *p) -> T {
 template <typename HardwareInterface = cpp_mem_iface> struct mmio_bus {
     using iface = HardwareInterface;
 
-    template <stdx::ct_string, auto Mask, decltype(Mask) IdMask,
-              decltype(Mask) IdValue>
-        requires std::unsigned_integral<decltype(Mask)>
-    static auto write(auto addr, decltype(Mask) value) -> async::sender auto {
-        static_assert((Mask & IdMask) == decltype(Mask){});
-        static_assert((Mask & IdValue) == decltype(Mask){});
+    // A HardwareInterface opts in to coalescing accesses to adjacent registers
+    // by declaring coalesce_t: the widest access it may use to do so.
+    template <std::unsigned_integral T>
+    consteval static auto can_coalesce(std::uintptr_t addr) -> bool {
+        if constexpr (requires { typename iface::coalesce_t; }) {
+            return sizeof(T) <= sizeof(typename iface::coalesce_t) and
+                   addr % iface::template alignment<T> == 0;
+        } else {
+            return false;
+        }
+    }
+
+  private:
+    template <typename Subword, std::unsigned_integral T>
+    static auto store_subword(std::uintptr_t iaddr, T write_val)
+        -> async::sender auto {
+        using subword_t = typename Subword::subword_t;
+        auto const subword_addr = iaddr + Subword::offset;
+        auto const subword_write_val =
+            static_cast<subword_t>(write_val >> (Subword::offset * 8));
+
+        return async::just(subword_write_val) |
+               iface::template store<subword_t>(subword_addr);
+    }
+
+    // Several subword stores are only used instead of a read-modify-write when
+    // the interface publishes access costs that make them cheaper.
+    template <auto Mask, typename Subwords>
+    consteval static auto plan_subword_stores() {
+        using base_type = decltype(Mask);
+        if constexpr (detail::costed_interface<iface>) {
+            auto plan = detail::plan_subword_stores<iface, Mask>(Subwords{});
+            constexpr auto rmw_cost =
+                static_cast<std::size_t>(
+                    iface::template load_cost<base_type>) +
+                static_cast<std::size_t>(
+                    iface::template store_cost<base_type>);
+            plan.valid = plan.valid and plan.cost < rmw_cost;
+            return plan;
+        } else {
+            return detail::subword_store_plan<sizeof(base_type)>{};
+        }
+    }
+
+    // A HardwareInterface may perform read-modify-write itself (e.g.
+    // atomically) by providing modify<T>(addr, keep): an adaptor like store
+    // that replaces the bits not in keep with the value it is given.
+    template <typename T>
+    constexpr static bool has_modify = requires(std::uintptr_t iaddr) {
+        iface::template modify<T>(iaddr, T{});
+    };
 
+    template <auto Mask, decltype(Mask) IdMask> struct write_strategy {
         using base_type = decltype(Mask);
 
         using subwords_aligned =
@@ -146,19 +290,50 @@ template <typename HardwareInterface = cpp_mem_iface> struct mmio_bus {
             detail::mp_copy_if_q<subwords_aligned_and_fit,
                                  detail::subword_satisfies<Mask, IdMask>>;
 
-        auto iaddr = detail::convert_addr<std::uintptr_t>(addr);
+        using covered_subwords =
+            detail::mp_copy_if_q<subwords_aligned_and_fit,
+                                 detail::subword_covered<Mask, IdMask>>;
+
+        constexpr static bool single_store =
+            not detail::mp_empty<subword_candidates>::value;
+        constexpr static auto subword_stores =
+            plan_subword_stores<Mask, covered_subwords>();
+        constexpr static bool multiple_stores =
+            not single_store and subword_stores.valid;
+    };
 
-        if constexpr (!detail::mp_empty<subword_candidates>::value) {
-            using subword = detail::mp_first<subword_candidates>;
-            using subword_t = typename subword::subword_t;
+  public:
+    template <stdx::ct_string, auto Mask, decltype(Mask) IdMask,
+              decltype(Mask) IdValue>
+        requires std::unsigned_integral<decltype(Mask)>
+    static auto write(auto addr, decltype(Mask) value) -> async::sender auto {
+        static_assert((Mask & IdMask) == decltype(Mask){});
+        static_assert((Mask & IdValue) == decltype(Mask){});
+
+        using base_type = decltype(Mask);
+        using strategy = write_strategy<Mask, IdMask>;
 
-            auto const write_val = value | IdValue;
-            auto const subword_addr = iaddr + subword::offset;
-            auto const subword_write_val =
-                static_cast<subword_t>(write_val >> (subword::offset * 8));
+        auto iaddr = detail::convert_addr<std::uintptr_t>(addr);
 
-            return async::just(subword_write_val) |
-                   iface::template store<subword_t>(subword_addr);
+        if constexpr (strategy::single_store) {
+            return store_subword<
+                detail::mp_first<typename strategy::subword_candidates>>(
+                iaddr, static_cast<base_type>(value | IdValue));
+
+        } else if constexpr (strategy::multiple_stores) {
+            return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                return async::when_all(
+                    store_subword<detail::mp_at_c<
+                        typename strategy::covered_subwords,
+                        strategy::subword_stores.subwords[Is]>>(
+                        iaddr, static_cast<base_type>(value | IdValue))...);
+            }(std::make_index_sequence<strategy::subword_stores.num_stores>{});
+
+        } else if constexpr (has_modify<base_type>) {
+            constexpr auto keep = static_cast<base_type>(~Mask & ~IdMask);
+            return async::just(static_cast<base_type>((value & Mask) |
+                                                      IdValue)) |
+                   iface::template modify<base_type>(iaddr, keep);
 
         } else {
             return iface::template load<base_type>(iaddr) |
@@ -172,6 +347,37 @@ template <typename HardwareInterface = cpp_mem_iface> struct mmio_bus {
         }
     }
 
+    // the accesses that write<Name, Mask, IdMask, IdValue>(addr) will make
+    template <auto Mask, decltype(Mask) IdMask>
+        requires std::unsigned_integral<decltype(Mask)>
+    consteval static auto plan_write(std::string_view name,
+                                     std::uintptr_t addr) {
+        using strategy = write_strategy<Mask, IdMask>;
+        bus_plan<sizeof(Mask)> p{};
+
+        auto const store = [&]<typename Subword>() {
+            p.push_back({name, addr + Subword::offset,
+                         sizeof(typename Subword::subword_t),
+                         bus_access::store});
+        };
+
+        if constexpr (strategy::single_store) {
+            store.template operator()<
+                detail::mp_first<typename strategy::subword_candidates>>();
+        } else if constexpr (strategy::multiple_stores) {
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                (store.template operator()<detail::mp_at_c<
+                     typename strategy::covered_subwords,
+                     strategy::subword_stores.subwords[Is]>>(),
+                 ...);
+            }(std::make_index_sequence<strategy::subword_stores.num_stores>{});
+        } else {
+            p.push_back(
+                {name, addr, sizeof(Mask), bus_access::read_modify_write});
+        }
+        return p;
+    }
+
     template <stdx::ct_string, std::unsigned_integral auto Mask>
     static auto read(auto addr) -> async::sender auto {
         using base_type = decltype(Mask);
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <groov/config.hpp>
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/write.hpp>
+#include <groov/write_spec.hpp>
+
+#include <async/compose.hpp>
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+#include <async/just_result_of.hpp>
+#include <async/let_value.hpp>
+#include <async/sync_wait.hpp>
+#include <async/then.hpp>
+#include <async/variant_sender.hpp>
+#include <async/when_all.hpp>
+
+#include <conc/concurrency.hpp>
+
+#include <stdx/concepts.hpp>
+#include <stdx/static_assert.hpp>
+#include <stdx/tuple.hpp>
+#include <stdx/utility.hpp>
+
+#include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/list.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace groov {
+struct unguarded;
+struct in_critical_section;
+
+// The error sent by modify<in_critical_section> when the read or the write it
+// makes inside the critical section fails.
+struct modify_error {};
+
+namespace detail {
+// Every bit of a modified register that does not have an identity value is
+// both read and written, so that the write covers the whole register and
+// needs no further load.
+template <typename IdMask>
+using modify_mask_t =
+    std::integral_constant<typename IdMask::value_type,
+                           static_cast<typename IdMask::value_type>(
+                               ~IdMask::value)>;
+
+template <typename Spec> struct modify_traits : write_traits<Spec> {
+    using base_t = write_traits<Spec>;
+    using bus_t = typename base_t::bus_t;
+
+    using id_masks_t = boost::mp11::mp_transform<
+        bitwise_or_t, typename base_t::identity_masks_t,
+        typename base_t::reg_identity_masks_t>;
+    using id_values_t = boost::mp11::mp_transform<
+        bitwise_or_t, typename base_t::identity_values_t,
+        typename base_t::reg_identity_values_t>;
+    using masks_t = boost::mp11::mp_transform<modify_mask_t, id_masks_t>;
+
+    using reads_t = boost::mp11::mp_transform<
+        register_read, typename Spec::value_t, masks_t>;
+    constexpr static auto read_plan = plan_coalesce<bus_t>(
+        boost::mp11::mp_rename<reads_t, boost::mp11::mp_list>{});
+
+    using writes_t =
+        boost::mp11::mp_transform<register_write, typename Spec::value_t,
+                                  masks_t, id_masks_t, id_values_t>;
+    constexpr static auto write_plan = plan_coalesce<bus_t>(
+        boost::mp11::mp_rename<writes_t, boost::mp11::mp_list>{});
+};
+
+// bits with identity values are written with those, not with what was read
+template <typename W> constexpr auto apply_mask(auto &r) -> void {
+    r.value = static_cast<decltype(W::mask)>(r.value & W::mask);
+}
+
+template <typename Writes> constexpr auto apply_masks(auto &values) -> void {
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        (apply_mask<boost::mp11::mp_at_c<Writes, Is>>(stdx::get<Is>(values)),
+         ...);
+    }(std::make_index_sequence<boost::mp11::mp_size<Writes>::value>{});
+}
+
+template <typename R, typename F>
+consteval auto check_modify_read_effect() -> void {
+    STATIC_ASSERT(not has_read_effect<F>::value,
+                  "modify() would read register {}, but {} has side effects "
+                  "on read",
+                  R::name, F::name);
+}
+
+template <typename R, typename... Fs>
+consteval auto check_modify_register(boost::mp11::mp_list<Fs...>) -> void {
+    (check_modify_read_effect<R, Fs>(), ...);
+}
+
+template <typename... Rs>
+consteval auto check_modify_read_effects(boost::mp11::mp_list<Rs...>) -> void {
+    (check_modify_register<Rs>(read_effects_t<Rs>{}), ...);
+}
+
+template <typename Group, typename Paths, typename F>
+auto modify_unguarded(read_spec<Group, Paths> const &s, F f)
+    -> async::sender auto {
+    using Spec = decltype(to_write_spec(s));
+    using traits = modify_traits<Spec>;
+    using bus_t = typename traits::bus_t;
+
+    check_read_only<bus_t, typename traits::fields_per_reg_t>();
+    check_write_only<bus_t, typename traits::all_fields_per_reg_t,
+                     typename traits::masks_t>();
+    check_modify_read_effects(
+        boost::mp11::mp_rename<typename Spec::value_t, boost::mp11::mp_list>{});
+
+    return [&]<std::size_t... Runs>(std::index_sequence<Runs...>) {
+        return async::when_all(
+            read_run<Group, typename traits::reads_t, traits::read_plan,
+                     Runs>(s.index)...);
+    }(std::make_index_sequence<traits::read_plan.num_runs>{}) |
+           async::then(split_runs<void, Spec, typename traits::reads_t,
+                                  traits::read_plan>(s.index)) |
+           async::let_value([f = std::move(f)](Spec spec) {
+               f(spec);
+               apply_masks<typename traits::writes_t>(spec.value);
+               return write_runs<bus_t, typename traits::writes_t,
+                                 traits::write_plan>(spec);
+           });
+}
+
+template <typename Guard, typename Group, typename Paths, typename F>
+auto guarded_modify(read_spec<Group, Paths> const &s, F f)
+    -> async::sender auto {
+    if constexpr (std::is_same_v<Guard, in_critical_section>) {
+        using S = decltype(modify_unguarded(s, std::move(f)));
+        static_assert(async::trivially_sync_waitable<S>,
+                      "modify<in_critical_section>() would block inside the "
+                      "critical section");
+        auto run = [s, f = std::move(f)] {
+            auto ok = false;
+            conc::call_in_critical_section<Group>([&] {
+                ok = static_cast<bool>(modify_unguarded(s, f) |
+                                       async::sync_wait());
+            });
+            return ok;
+        };
+        if constexpr (can_fail<S>) {
+            return async::just_result_of(std::move(run)) |
+                   async::let_value([](bool ok) {
+                       return async::make_variant_sender(
+                           ok, [] { return async::just(); },
+                           [] { return async::just_error(modify_error{}); });
+                   });
+        } else {
+            return async::just_result_of(
+                [run = std::move(run)]() -> void { run(); });
+        }
+    } else {
+        return modify_unguarded(s, std::move(f));
+    }
+}
+} // namespace detail
+
+template <typename Guard = unguarded, typename Group, typename Paths,
+          typename F>
+auto modify(read_spec<Group, Paths> const &s, F &&f) -> async::sender auto {
+    return detail::guarded_modify<Guard>(s, std::forward<F>(f));
+}
+
+namespace _modify {
+template <typename Guard, typename F> struct pipeable {
+    F f;
+
+  private:
+    template <async::sender S, stdx::same_as_unqualified<pipeable> P>
+    friend constexpr auto operator|(S &&s, P &&p) -> async::sender auto {
+        return std::forward<S>(s) |
+               async::let_value([f = std::forward<P>(p).f](auto &&spec) {
+                   return modify<Guard>(FWD(spec), f);
+               });
+    }
+};
+} // namespace _modify
+
+template <typename Guard = unguarded, typename F>
+constexpr auto modify(F &&f) {
+    return async::compose(
+        _modify::pipeable<Guard, std::decay_t<F>>{std::forward<F>(f)});
+}
+} // namespace groov
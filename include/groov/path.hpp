@@ -12,6 +12,7 @@
 #include <boost/mp11/list.hpp>
 
 #include <concepts>
+#include <cstddef>
 #include <type_traits>
 
 namespace groov {
@@ -26,6 +27,10 @@ template <stdx::ct_string... Parts> struct path {
         return (*this)(value);
     }
 
+    constexpr auto operator[](std::size_t i) const -> indexed<path> {
+        return {*this, i};
+    }
+
     template <pathlike P> constexpr static auto resolve(P) {
         constexpr auto len = sizeof...(Parts);
         constexpr auto other_len = boost::mp11::mp_size<P>::value;
@@ -71,6 +76,24 @@ template <stdx::ct_string... Parts> struct path {
     }
 };
 
+// A path through an element of a register array (see reg_array): the path is
+// resolved at compile time, and the index chosen at runtime.
+template <typename P> struct indexed {
+    P path;
+    std::size_t index;
+
+    template <typename... Vs> constexpr auto operator()(Vs const &...vs) const {
+        using VP = decltype(path(vs...));
+        return indexed<VP>{path(vs...), index};
+    }
+
+    template <typename T>
+    // NOLINTNEXTLINE(misc-unconventional-assign-operator)
+    constexpr auto operator=(T const &value) const {
+        return (*this)(value);
+    }
+};
+
 template <stdx::ct_string P, stdx::ct_string... Ps>
 constexpr auto parent(path<P, Ps...> const &) {
     return boost::mp11::mp_take_c<path<P, Ps...>, sizeof...(Ps)>{};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace groov {
+enum struct bus_access : std::uint8_t { load, store, read_modify_write };
+
+// One access that a write will make on the bus: the register it is made for,
+// the address and width (in bytes) of the access, and its kind.
+struct bus_op {
+    std::string_view name{};
+    std::uintptr_t address{};
+    std::size_t width{};
+    bus_access access{};
+
+    friend constexpr auto operator==(bus_op const &, bus_op const &)
+        -> bool = default;
+};
+
+// The sequence of accesses that a write will make on the bus, in the order
+// that they are emitted. Addresses of registers whose addresses are not
+// compile-time integers are reported relative to zero.
+template <std::size_t N> struct bus_plan {
+    std::array<bus_op, N> ops{};
+    std::size_t num_ops{};
+
+    constexpr auto push_back(bus_op op) -> void { ops[num_ops++] = op; }
+
+    [[nodiscard]] constexpr auto size() const -> std::size_t { return num_ops; }
+    [[nodiscard]] constexpr auto begin() const { return ops.begin(); }
+    [[nodiscard]] constexpr auto end() const { return ops.begin() + num_ops; }
+    [[nodiscard]] constexpr auto operator[](std::size_t i) const
+        -> bus_op const & {
+        return ops[i];
+    }
+
+    [[nodiscard]] constexpr auto count(bus_access access) const
+        -> std::size_t {
+        auto n = std::size_t{};
+        for (auto const &op : *this) {
+            n += op.access == access ? 1u : 0u;
+        }
+        return n;
+    }
+
+    // a read-modify-write counts as both a load and a store
+    [[nodiscard]] constexpr auto num_loads() const -> std::size_t {
+        return count(bus_access::load) + count(bus_access::read_modify_write);
+    }
+    [[nodiscard]] constexpr auto num_stores() const -> std::size_t {
+        return count(bus_access::store) +
+               count(bus_access::read_modify_write);
+    }
+};
+
+template <std::size_t... Ns>
+constexpr auto concat(bus_plan<Ns> const &...plans) {
+    bus_plan<(0u + ... + Ns)> p{};
+    (
+        [&] {
+            for (auto const &op : plans) {
+                p.push_back(op);
+            }
+        }(),
+        ...);
+    return p;
+}
+} // namespace groov
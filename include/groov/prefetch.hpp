@@ -0,0 +1,124 @@
+#pragma once
+
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/wait_until.hpp>
+
+#include <async/concepts.hpp>
+#include <async/connect.hpp>
+#include <async/start.hpp>
+#include <async/sync_wait.hpp>
+
+#include <stdx/type_traits.hpp>
+
+#include <atomic>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace groov {
+namespace detail {
+template <typename S>
+using sender_value_t = std::remove_cvref_t<decltype(get<0>(
+    *(std::declval<S>() | async::sync_wait())))>;
+} // namespace detail
+
+// A read that has been started but not yet used. The bus transactions are
+// issued when the handle is made; collect() waits for them to complete (if
+// they have not already) and returns what the read sent. If the read may fail
+// (the bus may send an error, or the read may be stopped), collect() returns
+// an optional, which is empty when the read failed.
+//
+// Until the read completes, collect() waits on the pause() of Strategy, as
+// wait_until does between reads: spin by default, or, say, yield_to a
+// scheduler that the calling thread must drive for the read to complete.
+template <typename Sender, detail::wait_strategy Strategy = spin>
+class prefetch_handle {
+    using value_t = detail::sender_value_t<Sender>;
+    using result_t = stdx::conditional_t<detail::can_fail<Sender>,
+                                         std::optional<value_t>, value_t>;
+
+    struct receiver {
+        using is_receiver = void;
+        prefetch_handle *handle;
+
+        auto set_value(value_t v) const -> void {
+            handle->value = std::move(v);
+            handle->done.store(true, std::memory_order_release);
+        }
+        auto set_error(auto &&...) const -> void {
+            handle->done.store(true, std::memory_order_release);
+        }
+        auto set_stopped() const -> void {
+            handle->done.store(true, std::memory_order_release);
+        }
+    };
+
+    std::optional<value_t> value{};
+    std::atomic<bool> done{};
+    Strategy strategy;
+    decltype(async::connect(std::declval<Sender>(),
+                            std::declval<receiver>())) op;
+
+    auto wait() -> void {
+        while (not is_ready()) {
+            [[maybe_unused]] auto r = strategy.pause() | async::sync_wait();
+        }
+    }
+
+  public:
+    explicit prefetch_handle(Sender s, Strategy st = {})
+        : strategy{std::move(st)},
+          op(async::connect(std::move(s), receiver{this})) {
+        async::start(op);
+    }
+
+    // the operation refers to the handle, so the handle stays where it is
+    prefetch_handle(prefetch_handle const &) = delete;
+    auto operator=(prefetch_handle const &) -> prefetch_handle & = delete;
+
+    // a read that was never collected is still waited for
+    ~prefetch_handle() { wait(); }
+
+    [[nodiscard]] auto is_ready() const -> bool {
+        return done.load(std::memory_order_acquire);
+    }
+
+    // Wait for the read to complete and return its value. This may be called
+    // once.
+    [[nodiscard]] auto collect() -> result_t {
+        wait();
+        if constexpr (detail::can_fail<Sender>) {
+            return std::move(value);
+        } else {
+            return *std::move(value);
+        }
+    }
+};
+
+// Start reading a spec now, and collect the values later: the CPU is free to
+// do other work while the bus transactions are in flight.
+template <typename T = void, typename Group, typename Paths,
+          detail::wait_strategy Strategy = spin>
+[[nodiscard]] auto prefetch(read_spec<Group, Paths> const &s,
+                            Strategy strategy = {}) {
+    using S = decltype(read_as<T>(s));
+    return prefetch_handle<S, Strategy>{read_as<T>(s), std::move(strategy)};
+}
+
+namespace _collect {
+struct pipeable {
+  private:
+    template <typename H>
+        requires stdx::is_specialization_of_v<std::remove_cvref_t<H>,
+                                              prefetch_handle>
+    friend auto operator|(H &&h, pipeable) {
+        return h.collect();
+    }
+};
+} // namespace _collect
+
+[[nodiscard]] constexpr inline auto collect() -> _collect::pipeable {
+    return {};
+}
+} // namespace groov
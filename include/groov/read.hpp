@@ -1,15 +1,19 @@
 #pragma once
 
+#include <groov/coalesce.hpp>
 #include <groov/config.hpp>
+#include <groov/constant.hpp>
 #include <groov/path.hpp>
 #include <groov/read_spec.hpp>
 #include <groov/write_spec.hpp>
 
 #include <async/compose.hpp>
 #include <async/concepts.hpp>
+#include <async/env.hpp>
 #include <async/let_value.hpp>
 #include <async/sync_wait.hpp>
 #include <async/then.hpp>
+#include <async/type_traits.hpp>
 #include <async/when_all.hpp>
 
 #include <stdx/optional.hpp>
@@ -22,17 +26,214 @@
 #include <boost/mp11/list.hpp>
 
 #include <concepts>
+#include <cstddef>
 #include <optional>
 #include <type_traits>
 #include <utility>
 
 namespace groov {
+// A mapping for read_as: the paths of a read are stored, in order, into these
+// members of a struct.
+template <auto... Members>
+    requires(sizeof...(Members) > 0 and
+             (... and std::is_member_object_pointer_v<decltype(Members)>))
+struct members {};
+
 namespace detail {
+// Whether a sender may complete without a value: sync_wait on it may then
+// give back an empty optional.
+template <typename S>
+constexpr auto can_fail =
+    not boost::mp11::mp_empty<async::error_types_of_t<
+        S, async::empty_env, boost::mp11::mp_list>>::value or
+    async::sends_stopped<S>;
+
+template <typename T> constexpr auto is_members = false;
+template <auto... Ms> constexpr auto is_members<members<Ms...>> = true;
+
+template <typename T> struct member_class;
+template <typename M, typename C> struct member_class<M C::*> {
+    using type = C;
+};
+
+template <typename T, typename Spec> struct read_result {
+    using type = stdx::conditional_t<std::is_void_v<T>, Spec, T>;
+};
+template <auto M, auto... Ms, typename Spec>
+struct read_result<members<M, Ms...>, Spec> {
+    using type = typename member_class<decltype(M)>::type;
+};
+
+// what read_as<T> sends: the spec itself (for void), or a T
+template <typename T, typename Spec>
+using read_result_t = typename read_result<T, Spec>::type;
+
+template <typename Spec, typename P> struct path_register {
+    using registers_t =
+        boost::mp11::mp_rename<typename Spec::value_t, boost::mp11::mp_list>;
+    using type = boost::mp11::mp_front<
+        boost::mp11::mp_copy_if_q<registers_t, resolves_q<P>>>;
+    constexpr static auto index =
+        boost::mp11::mp_find<registers_t, type>::value;
+};
+
+// the value at path P, extracted from the register values of a read
+template <typename Spec, typename P>
+constexpr auto path_value(auto const &values) {
+    using R = path_register<Spec, P>;
+    using F = resolve_t<typename R::type, P>;
+    return F::extract(stdx::get<R::index>(values));
+}
+
+template <typename Spec, typename... Ps>
+constexpr auto path_values(boost::mp11::mp_list<Ps...>, auto const &values) {
+    return stdx::tuple{path_value<Spec, Ps>(values)...};
+}
+
+template <typename Spec> struct path_type_q {
+    template <typename P>
+    using fn = typename resolve_t<typename path_register<Spec, P>::type,
+                                  P>::type_t;
+};
+
+// converts to anything, to stand for a member that no path fills
+struct any_member {
+    template <typename U> operator U() const;
+};
+
+// T is made from exactly these values: one more would not fit
+template <typename T, typename... Vs>
+constexpr auto brace_constructible(boost::mp11::mp_list<Vs...>) -> bool {
+    return requires(Vs... vs) { T{vs...}; } and
+           not requires(Vs... vs) { T{vs..., any_member{}}; };
+}
+
+// an aggregate that is not made from the spec gets one member per path
+template <typename T, typename Spec>
+concept aggregate_projection =
+    not std::convertible_to<Spec, T> and std::is_aggregate_v<T> and
+    brace_constructible<T>(
+        boost::mp11::mp_transform_q<path_type_q<Spec>,
+                                    typename Spec::paths_t>{});
+
+// Build the result of a read from its register values. A struct is filled
+// straight from the fields at each path, without making a spec.
+template <typename T, typename Spec>
+constexpr auto make_result(std::size_t index, auto const &...values)
+    -> read_result_t<T, Spec> {
+    using R = read_result_t<T, Spec>;
+    auto const vs = stdx::tuple{values...};
+    if constexpr (is_members<T>) {
+        return []<auto... Ms>(members<Ms...>, auto const &pvs) {
+            R r{};
+            pvs.apply([&](auto const &...v) { ((r.*Ms = v), ...); });
+            return r;
+        }(T{}, path_values<Spec>(typename Spec::paths_t{}, vs));
+    } else if constexpr (aggregate_projection<T, Spec>) {
+        return path_values<Spec>(typename Spec::paths_t{}, vs)
+            .apply([](auto const &...v) { return R{v...}; });
+    } else {
+        using Rs = typename Spec::value_t;
+        return [&]<std::size_t... Is>(std::index_sequence<Is...>) -> R {
+            auto s = Spec{
+                {}, {}, {stdx::tuple_element_t<Is, Rs>{{}, get<Is>(vs)}...}};
+            set_index(s, index);
+            return s;
+        }(std::make_index_sequence<sizeof...(values)>{});
+    }
+}
+
 template <typename Register, typename Group, typename Mask>
-auto read() -> async::sender auto {
+auto read(std::size_t index = 0) -> async::sender auto {
     using bus_t = typename Group::bus_t;
-    return bus_t::template read<Register::name, Mask::value>(
-        get_address<Register>());
+    if constexpr (constant_register<Register>) {
+        return read_constant<bus_t, Register>();
+    } else {
+        return bus_t::template read<Register::name, Mask::value>(
+            element_address<Register>(index));
+    }
+}
+
+template <typename Register, typename Mask> struct register_read {
+    using register_t = Register;
+    using mask_t = Mask;
+    constexpr static auto mask = Mask::value;
+
+    constexpr static auto address = constant_address<Register>();
+    // a wide load must not touch a register with side effects on read, a
+    // constant register is read through its cache, and the address of a
+    // register array element is only known at runtime
+    constexpr static bool coalescable = constant_addressed<Register> and
+                                        not has_read_effects<Register> and
+                                        not constant_register<Register> and
+                                        not register_array<Register>;
+};
+
+template <typename Group, typename... Rs>
+auto read_coalesced() -> async::sender auto {
+    using bus_t = typename Group::bus_t;
+    using first_t = boost::mp11::mp_front<boost::mp11::mp_list<Rs...>>;
+    using register_t = typename first_t::register_t;
+    constexpr auto base = first_t::address;
+    using wide_t = coalesced_t<Rs...>;
+
+    constexpr auto mask =
+        (wide_t{} | ... | to_lane<wide_t, base, Rs>(Rs::mask));
+    return bus_t::template read<register_t::name, mask>(
+        get_address<register_t>());
+}
+
+template <typename Group, typename Reads, auto Plan, std::size_t Run>
+auto read_run(std::size_t index) -> async::sender auto {
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        if constexpr (sizeof...(Is) == 1) {
+            using R = boost::mp11::mp_at_c<Reads, Plan.order[Plan.first[Run]]>;
+            return read<typename R::register_t, Group, typename R::mask_t>(
+                index);
+        } else {
+            return read_coalesced<
+                Group, boost::mp11::mp_at_c<
+                           Reads, Plan.order[Plan.first[Run] + Is]>...>();
+        }
+    }(std::make_index_sequence<Plan.length[Run]>{});
+}
+
+template <typename Reads, auto Plan, std::size_t I>
+constexpr auto register_value(auto const &run_values) {
+    constexpr auto run = Plan.run_of(I);
+    auto const value = stdx::get<run>(run_values);
+    if constexpr (Plan.length[run] == 1) {
+        return value;
+    } else {
+        using first_t = boost::mp11::mp_at_c<Reads, Plan.order[Plan.first[run]]>;
+        return from_lane<decltype(value), first_t::address,
+                         boost::mp11::mp_at_c<Reads, I>>(value);
+    }
+}
+
+template <typename T, typename Spec, typename Reads, auto Plan>
+constexpr auto from_runs(std::size_t index, auto const &...run_values) {
+    auto const values = stdx::tuple{run_values...};
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return make_result<T, Spec>(
+            index, register_value<Reads, Plan, Is>(values)...);
+    }(std::make_index_sequence<boost::mp11::mp_size<Reads>::value>{});
+}
+
+template <typename T, typename Spec, typename Reads, auto Plan>
+constexpr auto split_runs(std::size_t index) {
+    return [=]<typename... Vs>(Vs const &...values) {
+        if constexpr ((... and
+                       stdx::is_specialization_of_v<Vs, std::optional>)) {
+            return stdx::transform(
+                [=](auto const &...vs) {
+                    return from_runs<T, Spec, Reads, Plan>(index, vs...);
+                },
+                values...);
+        } else {
+            return from_runs<T, Spec, Reads, Plan>(index, values...);
+        }
+    };
 }
 
 template <typename Path> struct to_register;
@@ -86,11 +287,27 @@ consteval auto check_write_only() -> void {
 }
 
 template <typename T, typename Spec> consteval auto check_read_conversion() {
-    STATIC_ASSERT(
-        (std::convertible_to<Spec, T>),
-        "Cannot convert the result of read ({}) to {} -- are you reading "
-        "multiple paths?",
-        Spec, T);
+    if constexpr (is_members<T>) {
+        constexpr auto num_members =
+            []<auto... Ms>(members<Ms...>) { return sizeof...(Ms); }(T{});
+        STATIC_ASSERT(num_members ==
+                          boost::mp11::mp_size<typename Spec::paths_t>::value,
+                      "Cannot read into {}: there must be one member for "
+                      "each path",
+                      T);
+    } else if constexpr (std::is_aggregate_v<T> and
+                         not std::convertible_to<Spec, T>) {
+        STATIC_ASSERT((aggregate_projection<T, Spec>),
+                      "Cannot read into {}: it must have exactly one member "
+                      "for each path, in order",
+                      T);
+    } else if constexpr (not std::is_void_v<T>) {
+        STATIC_ASSERT(
+            (std::convertible_to<Spec, T>),
+            "Cannot convert the result of read ({}) to {} -- are you reading "
+            "multiple paths?",
+            Spec, T);
+    }
 }
 } // namespace detail
 
@@ -112,25 +329,41 @@ constexpr auto read_as(read_spec<Group, Paths> const &s) -> async::sender auto {
     detail::check_write_only<typename Spec::bus_t, read_fields_per_reg_t,
                              field_masks_t>();
 
-    using R = stdx::conditional_t<std::is_void_v<T>, Spec, T>;
-    detail::check_read_conversion<R, Spec>();
-
-    return []<typename... Rs, typename... Ms>(stdx::tuple<Rs...>,
-                                              stdx::tuple<Ms...>) {
-        return async::when_all(detail::read<Rs, Group, Ms>()...) |
-               async::then(stdx::overload{
-                   [](typename Rs::type_t... values) -> R {
-                       return Spec{{}, {Rs{{}, values}...}};
-                   },
-                   [](std::optional<typename Rs::type_t>... values)
-                       -> std::optional<R> {
-                       return stdx::transform(
-                           [](auto... vs) -> R {
-                               return Spec{{}, {Rs{{}, vs}...}};
-                           },
-                           values...);
-                   }});
-    }(typename Spec::value_t{}, field_masks_t{});
+    using R = detail::read_result_t<T, Spec>;
+    detail::check_read_conversion<T, Spec>();
+
+    using reads_t =
+        boost::mp11::mp_transform<detail::register_read,
+                                  typename Spec::value_t, field_masks_t>;
+    constexpr auto plan = detail::plan_coalesce<typename Spec::bus_t>(
+        boost::mp11::mp_rename<reads_t, boost::mp11::mp_list>{});
+
+    if constexpr (plan.num_runs == boost::mp11::mp_size<reads_t>::value) {
+        return [i = s.index]<typename... Rs, typename... Ms>(
+                   stdx::tuple<Rs...>, stdx::tuple<Ms...>) {
+            return async::when_all(detail::read<Rs, Group, Ms>(i)...) |
+                   async::then(stdx::overload{
+                       [=](typename Rs::type_t... values) -> R {
+                           return detail::make_result<T, Spec>(i, values...);
+                       },
+                       [=](std::optional<typename Rs::type_t>... values)
+                           -> std::optional<R> {
+                           return stdx::transform(
+                               [=](auto... vs) -> R {
+                                   return detail::make_result<T, Spec>(
+                                       i, vs...);
+                               },
+                               values...);
+                       }});
+        }(typename Spec::value_t{}, field_masks_t{});
+    } else {
+        return [&]<std::size_t... Runs>(std::index_sequence<Runs...>) {
+            return async::when_all(detail::read_run<Group, reads_t, plan,
+                                                    Runs>(s.index)...) |
+                   async::then(
+                       detail::split_runs<T, Spec, reads_t, plan>(s.index));
+        }(std::make_index_sequence<plan.num_runs>{});
+    }
 }
 
 namespace _read {
@@ -6,8 +6,11 @@
 
 #include <boost/mp11/list.hpp>
 
+#include <cstddef>
+
 namespace groov {
-template <typename Group, typename Paths> struct read_spec : Group {
+template <typename Group, typename Paths>
+struct read_spec : Group, detail::spec_index_for<Group, Paths> {
     using paths_t = Paths;
 };
 
@@ -9,6 +9,7 @@
 
 namespace groov {
 template <stdx::ct_string... Parts> struct path;
+template <typename P> struct indexed;
 
 template <typename T>
 concept pathlike = requires(T const &t) {
@@ -23,6 +24,10 @@ concept valued = requires { typename std::remove_cvref_t<T>::value_t; };
 template <typename T>
 concept valued_pathlike = pathlike<T> and valued<T>;
 
+template <typename T>
+concept indexed_pathlike =
+    stdx::is_specialization_of_v<std::remove_cvref_t<T>, indexed>;
+
 namespace detail {
 template <stdx::ct_string... Parts>
 constexpr auto get_path(path<Parts...> const &) -> path<Parts...>;
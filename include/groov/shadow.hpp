@@ -0,0 +1,144 @@
+#pragma once
+
+#include <groov/config.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/write_spec.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+#include <async/let_value.hpp>
+#include <async/then.hpp>
+#include <async/variant_sender.hpp>
+#include <async/when_all.hpp>
+
+#include <stdx/static_assert.hpp>
+#include <stdx/utility.hpp>
+
+#include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/list.hpp>
+
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+namespace groov {
+namespace attr {
+// A register with this attribute keeps a shadow copy of its value, so that
+// writing part of the register does not need to read it first.
+struct shadowed {
+    using is_register_attribute = void;
+};
+} // namespace attr
+
+namespace detail {
+template <typename R>
+concept shadowed_register = has_attribute<R, attr::shadowed>;
+
+template <typename Bus, typename Register> struct shadow {
+    static inline typename Register::type_t value{};
+    static inline bool valid{};
+};
+
+template <typename Bus, typename Register>
+using shadow_t = shadow<Bus, typename unwrap_register<Register>::type>;
+
+// A write that covers the whole register (apart from bits with identity
+// values, which the shadow never supplies) makes the shadow valid; any other
+// write keeps a valid shadow up to date.
+template <typename Bus, typename Register, auto Mask, auto IdMask>
+auto update_shadow(decltype(Mask) value) -> void {
+    using T = decltype(Mask);
+    using S = shadow_t<Bus, Register>;
+    if constexpr ((Mask | IdMask) == std::numeric_limits<T>::max()) {
+        S::value = value;
+        S::valid = true;
+    } else if (S::valid) {
+        S::value = static_cast<T>((S::value & ~Mask) | (value & Mask));
+    }
+}
+
+template <typename Register, typename Bus, auto Mask, auto IdMask,
+          auto IdValue>
+auto write_shadowed(decltype(Mask) value) -> async::sender auto {
+    using T = decltype(Mask);
+    auto const update = [=] {
+        update_shadow<Bus, Register, Mask, IdMask>(value);
+    };
+
+    if constexpr ((Mask | IdMask) == std::numeric_limits<T>::max()) {
+        return bus_write<Register, Bus, Mask, IdMask, IdValue>(
+                   get_address<Register>(), value) |
+               async::then(update);
+    } else {
+        using S = shadow_t<Bus, Register>;
+        constexpr auto shadow_mask = static_cast<T>(~IdMask);
+        // The shadow is consulted when the write starts, not when the sender
+        // is made: an earlier write to the register may not have run yet.
+        return async::just() | async::let_value([=] {
+                   return async::make_variant_sender(
+                       S::valid,
+                       [=] {
+                           auto const v = static_cast<T>(
+                               (S::value & shadow_mask & ~Mask) |
+                               (value & Mask));
+                           return bus_write<Register, Bus, shadow_mask,
+                                            IdMask, IdValue>(
+                                      get_address<Register>(), v) |
+                                  async::then(update);
+                       },
+                       [=] {
+                           return bus_write<Register, Bus, Mask, IdMask,
+                                            IdValue>(get_address<Register>(),
+                                                     value) |
+                                  async::then(update);
+                       });
+               });
+    }
+}
+
+template <typename Bus, typename Register>
+auto resync_register() -> async::sender auto {
+    using T = typename Register::type_t;
+    constexpr auto mask = std::numeric_limits<T>::max();
+    return Bus::template read<Register::name, mask>(get_address<Register>()) |
+           async::then(stdx::overload{
+               [](T value) { update_shadow<Bus, Register, mask, T{}>(value); },
+               [](std::optional<T> value) {
+                   if (value) {
+                       update_shadow<Bus, Register, mask, T{}>(*value);
+                   } else {
+                       shadow_t<Bus, Register>::valid = false;
+                   }
+               }});
+}
+
+template <typename Register> consteval auto check_shadowed() -> void {
+    STATIC_ASSERT(shadowed_register<Register>,
+                  "Attempting to resync or invalidate a register that is not "
+                  "shadowed: {}",
+                  Register::name);
+}
+
+template <typename Group, typename Paths>
+using spec_registers_t = boost::mp11::mp_rename<
+    typename decltype(to_write_spec(read_spec<Group, Paths>{}))::value_t,
+    boost::mp11::mp_list>;
+} // namespace detail
+
+template <typename Group, typename Paths>
+auto resync(read_spec<Group, Paths> const &) -> async::sender auto {
+    return []<typename... Rs>(boost::mp11::mp_list<Rs...>) {
+        (detail::check_shadowed<Rs>(), ...);
+        return async::when_all(
+            detail::resync_register<typename Group::bus_t, Rs>()...);
+    }(detail::spec_registers_t<Group, Paths>{});
+}
+
+template <typename Group, typename Paths>
+auto invalidate(read_spec<Group, Paths> const &) -> void {
+    []<typename... Rs>(boost::mp11::mp_list<Rs...>) {
+        (detail::check_shadowed<Rs>(), ...);
+        ((detail::shadow_t<typename Group::bus_t, Rs>::valid = false), ...);
+    }(detail::spec_registers_t<Group, Paths>{});
+}
+} // namespace groov
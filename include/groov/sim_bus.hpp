@@ -0,0 +1,189 @@
+#pragma once
+
+#include <groov/path.hpp>
+#include <groov/test.hpp>
+
+#include <async/concepts.hpp>
+#include <async/schedulers/thread_scheduler.hpp>
+#include <async/then.hpp>
+
+#include <stdx/ct_string.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <semaphore>
+#include <thread>
+#include <utility>
+
+namespace groov {
+namespace test {
+// Called once for each transaction to find how long it takes
+using latency_function = std::function<std::chrono::nanoseconds()>;
+
+// The same latency every time
+struct fixed_latency {
+    std::chrono::nanoseconds latency{};
+
+    auto operator()() const -> std::chrono::nanoseconds { return latency; }
+};
+
+// A latency drawn uniformly from [min, max]. A given seed gives the same
+// sequence of latencies every run.
+class uniform_latency {
+    std::uniform_int_distribution<std::chrono::nanoseconds::rep> dist;
+    std::minstd_rand engine;
+
+  public:
+    uniform_latency(std::chrono::nanoseconds min, std::chrono::nanoseconds max,
+                    std::uint32_t seed = 1)
+        : dist{min.count(), max.count()}, engine{seed} {}
+
+    auto operator()() -> std::chrono::nanoseconds {
+        return std::chrono::nanoseconds{dist(engine)};
+    }
+};
+
+// A test bus whose transactions take time. Each read or write completes on
+// Scheduler after a latency drawn for the register it accesses, and at most
+// MaxOutstanding transactions are in flight at once: any more wait for one to
+// complete before they start. Otherwise the bus behaves as test::bus, and uses
+// the same store.
+//
+// Transactions access the store from the scheduler's threads, and hold no lock
+// of the bus while they do, so that the store's callbacks may use the bus. With
+// one transaction in flight at a time they access the store one at a time;
+// a bus that allows more, or a test that uses the store while transactions are
+// in flight, needs the group's store to be a concurrent_store. An
+// isolated_store is not seen. Each transaction waits on the thread it runs on,
+// so Scheduler should run each one on a thread of its own, as
+// async::thread_scheduler does.
+template <stdx::ct_string Group, std::size_t MaxOutstanding = 1,
+          typename Scheduler = async::thread_scheduler,
+          typename XPolicy = optional_policy>
+struct sim_bus {
+    static_assert(MaxOutstanding > 0,
+                  "A simulated bus must allow at least one transaction");
+    static_assert(MaxOutstanding == 1 or concurrent_store<Group>,
+                  "A simulated bus that allows several transactions at once "
+                  "needs a concurrent_store");
+
+    template <stdx::ct_string RegName, auto Mask>
+    static auto read(auto addr) -> async::sender auto {
+        return transact<RegName>([=] {
+            return detail::read_store<Group, XPolicy, RegName, Mask>(addr);
+        });
+    }
+
+    template <stdx::ct_string RegName, auto Mask, auto IdMask, auto IdValue>
+    static auto write(auto addr, auto val) -> async::sender auto {
+        using T = decltype(Mask);
+        return transact<RegName>([=]() -> void {
+            detail::write_store<Group, detail::replace_model<T>, Mask, IdMask,
+                                IdValue>(addr, val);
+        });
+    }
+
+    template <typename Register, auto Mask, auto IdMask, auto IdValue>
+    static auto write_register(auto addr, auto val) -> async::sender auto {
+        using T = decltype(Mask);
+        return transact<Register::name>([=]() -> void {
+            detail::write_store<Group,
+                                detail::register_write_model<Register, T>(),
+                                Mask, IdMask, IdValue>(addr, val);
+        });
+    }
+
+    // The latency of transactions to one register (an empty function means
+    // the default), and of those to registers without one of their own.
+    // Latencies start at zero.
+    template <stdx::ct_string RegName>
+    static auto set_latency(latency_function f) -> void {
+        std::lock_guard lock{mutex};
+        latency<RegName> = std::move(f);
+    }
+    static auto set_latency(latency_function f) -> void {
+        std::lock_guard lock{mutex};
+        default_latency = std::move(f);
+    }
+
+    // The number of transactions in flight, and the most there have been at
+    // once since reset_peak_outstanding(): how well the code using the bus
+    // overlaps its transactions.
+    [[nodiscard]] static auto outstanding() -> std::size_t {
+        return num_outstanding.load();
+    }
+    [[nodiscard]] static auto peak_outstanding() -> std::size_t {
+        return peak.load();
+    }
+    static auto reset_peak_outstanding() -> void {
+        peak = num_outstanding.load();
+    }
+
+  private:
+    // one of the transactions that may be in flight at once
+    struct slot {
+        slot() {
+            slots.acquire();
+            auto const n = ++num_outstanding;
+            auto p = peak.load();
+            while (p < n and not peak.compare_exchange_weak(p, n)) {
+            }
+        }
+        ~slot() {
+            --num_outstanding;
+            slots.release();
+        }
+
+        slot(slot const &) = delete;
+        auto operator=(slot const &) -> slot & = delete;
+    };
+
+    template <stdx::ct_string RegName> static auto next_latency() {
+        std::lock_guard lock{mutex};
+        auto &f = latency<RegName> ? latency<RegName> : default_latency;
+        return f ? f() : std::chrono::nanoseconds{};
+    }
+
+    // The latency is counted from when the transaction is in flight, and the
+    // store is accessed when it completes, while the transaction still holds
+    // its slot.
+    template <stdx::ct_string RegName, typename F>
+    static auto transact(F f) -> async::sender auto {
+        return Scheduler{}.schedule() | async::then([=] {
+                   auto const s = slot{};
+                   std::this_thread::sleep_for(next_latency<RegName>());
+                   return f();
+               });
+    }
+
+    // guards the latency functions
+    static inline std::mutex mutex{};
+    template <stdx::ct_string RegName>
+    static inline latency_function latency{};
+    static inline latency_function default_latency{};
+
+    static inline std::counting_semaphore<MaxOutstanding> slots{
+        MaxOutstanding};
+    static inline std::atomic<std::size_t> num_outstanding{};
+    static inline std::atomic<std::size_t> peak{};
+};
+
+// Set the latency of transactions to the register at a path, for a group
+// whose bus is a sim_bus
+template <typename Group, pathlike P>
+void set_latency(P p, latency_function f) {
+    using Reg = decltype(Group::resolve(p));
+    Group::bus_t::template set_latency<Reg::name>(std::move(f));
+}
+
+template <typename Group, pathlike P>
+void set_latency(Group, P p, latency_function f) {
+    set_latency<Group>(p, std::move(f));
+}
+} // namespace test
+} // namespace groov
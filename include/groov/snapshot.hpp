@@ -0,0 +1,109 @@
+#pragma once
+
+#include <groov/config.hpp>
+#include <groov/constant.hpp>
+#include <groov/identity.hpp>
+#include <groov/path.hpp>
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/write.hpp>
+#include <groov/write_spec.hpp>
+
+#include <async/concepts.hpp>
+
+#include <stdx/ct_string.hpp>
+#include <stdx/static_assert.hpp>
+
+#include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/list.hpp>
+
+#include <concepts>
+#include <type_traits>
+
+namespace groov {
+namespace detail {
+// A node written with w::replace holds what was last written to it, so a
+// value read from it can be written back.
+template <typename W>
+concept replace_write_function =
+    set_write_function<W> and clear_write_function<W> and
+    not identity_write_function<W> and
+    std::same_as<typename W::set_spec, m::one> and
+    std::same_as<typename W::clear_spec, m::zero> and
+    not write_only_write_function<W> and not read_effect_write_function<W>;
+
+template <typename N>
+using is_restorable =
+    std::bool_constant<replace_write_function<typename N::write_fn_t>>;
+
+template <typename N>
+using is_all_restorable =
+    boost::mp11::mp_all_of<all_nodes_t<N>, is_restorable>;
+
+// Registers that are read-only, write-only, constant, have side effects on
+// read, or are arrays (whose elements are chosen at runtime) are not saved.
+template <typename R>
+using is_saved_register = std::bool_constant<
+    is_restorable<R>::value and not has_read_effects<R> and
+    not constant_register<R> and not register_array<R>>;
+
+template <typename R> struct field_path_q {
+    template <typename F> using fn = path<R::name, F::name>;
+};
+
+template <typename R>
+using restorable_field_paths_t = boost::mp11::mp_transform_q<
+    field_path_q<R>,
+    boost::mp11::mp_copy_if<typename R::children_t, is_all_restorable>>;
+
+// a register that can be restored whole is saved whole; otherwise only its
+// restorable fields are
+template <typename R>
+using snapshot_paths_t =
+    boost::mp11::mp_eval_if_c<is_all_restorable<R>::value,
+                              boost::mp11::mp_list<path<R::name>>,
+                              restorable_field_paths_t, R>;
+
+template <typename Group>
+using snapshot_spec_t = read_spec<
+    Group,
+    boost::mp11::mp_flatten<boost::mp11::mp_transform<
+        snapshot_paths_t, boost::mp11::mp_copy_if<typename Group::children_t,
+                                                  is_saved_register>>>>;
+
+template <typename Group> consteval auto check_snapshot() -> void {
+    STATIC_ASSERT(not boost::mp11::mp_empty<
+                      typename snapshot_spec_t<Group>::paths_t>::value,
+                  "Group {} has no registers that can be saved", Group::name);
+}
+} // namespace detail
+
+// The saved state of a group: the value of each of its writable registers
+template <typename Group>
+using snapshot_t =
+    decltype(to_write_spec(detail::snapshot_spec_t<Group>{}));
+
+// Read every register of a group that can be written back. Registers are
+// read in the order they are declared in the group; adjacent registers are
+// read together on a bus that can coalesce them.
+template <stdx::ct_string Name, typename Bus, typename... Registers>
+auto snapshot(group<Name, Bus, Registers...> const &) -> async::sender auto {
+    using G = group<Name, Bus, Registers...>;
+    detail::check_snapshot<G>();
+    return read(detail::snapshot_spec_t<G>{});
+}
+
+// Write a snapshot back to its group. Each write completes before the next
+// starts, in the order the registers are declared in the group; adjacent
+// registers are written together on a bus that can coalesce them.
+template <stdx::ct_string Name, typename Bus, typename... Registers>
+auto restore(group<Name, Bus, Registers...> const &,
+             snapshot_t<group<Name, Bus, Registers...>> const &s)
+    -> async::sender auto {
+    using traits = detail::write_traits<std::remove_cvref_t<decltype(s)>>;
+    detail::check_write<max_loads<>, traits>();
+    return detail::write_runs_in_order<typename traits::bus_t,
+                                       typename traits::writes_t,
+                                       traits::plan>(s);
+}
+} // namespace groov
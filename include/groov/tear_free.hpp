@@ -0,0 +1,165 @@
+#pragma once
+
+#include <groov/coalesce.hpp>
+#include <groov/config.hpp>
+#include <groov/path.hpp>
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/value_path.hpp>
+#include <groov/write.hpp>
+
+#include <async/concepts.hpp>
+#include <async/let_value.hpp>
+#include <async/repeat.hpp>
+#include <async/then.hpp>
+#include <async/when_all.hpp>
+
+#include <stdx/ct_string.hpp>
+#include <stdx/static_assert.hpp>
+
+#include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/list.hpp>
+
+#include <limits>
+#include <type_traits>
+
+namespace groov {
+// Sequences for reading a register pair without tearing.
+
+// Read the high word, the low word, then the high word again, and retry if
+// the high word changed in between.
+struct hi_lo_hi {};
+
+// The hardware latches the high word when the low word is read: read the low
+// word, then the high word.
+struct lo_latches_hi {};
+
+// The hardware copies both words to holding registers when Value is written to
+// the register or field at Path (in the same group): write it, then read both.
+template <stdx::ct_string Path, auto Value = 1u> struct latch_strobe {
+    constexpr static auto path = Path;
+    constexpr static auto value = Value;
+};
+
+namespace attr {
+// A register with this attribute holds the low word of a value whose high
+// word is the register named Hi in the same group. read_tear_free reads the
+// pair using Sequence.
+template <stdx::ct_string Hi, typename Sequence = hi_lo_hi> struct high_word {
+    using is_register_attribute = void;
+    constexpr static auto hi = Hi;
+    using sequence_t = Sequence;
+};
+} // namespace attr
+
+namespace detail {
+template <typename A>
+using is_high_word = std::bool_constant<requires {
+    A::hi;
+    typename A::sequence_t;
+}>;
+
+template <typename R>
+using high_words_of =
+    boost::mp11::mp_copy_if<typename R::attributes_t, is_high_word>;
+
+template <typename R>
+concept low_word_register = requires { typename R::attributes_t; } and
+                            not boost::mp11::mp_empty<high_words_of<R>>::value;
+
+template <typename R>
+using high_word_t = boost::mp11::mp_front<high_words_of<R>>;
+
+template <typename Register, typename Group> auto read_whole() {
+    using T = typename Register::type_t;
+    return read<Register, Group,
+                std::integral_constant<T, std::numeric_limits<T>::max()>>();
+}
+
+template <typename Wide, typename Lo>
+constexpr auto combine_words(auto hi, auto lo) -> Wide {
+    return static_cast<Wide>(
+        static_cast<Wide>(static_cast<Wide>(hi)
+                          << std::numeric_limits<typename Lo::type_t>::digits) |
+        static_cast<Wide>(lo));
+}
+
+template <typename Hi, typename Lo> struct pair_sample {
+    typename Hi::type_t hi;
+    typename Lo::type_t lo;
+    typename Hi::type_t hi_again;
+};
+
+template <typename Wide, typename Group, typename Lo, typename Hi>
+auto read_pair(hi_lo_hi) -> async::sender auto {
+    using sample_t = pair_sample<Hi, Lo>;
+    return read_whole<Hi, Group>() |
+           async::let_value([](auto hi) {
+               return read_whole<Lo, Group>() |
+                      async::let_value([hi](auto lo) {
+                          return read_whole<Hi, Group>() |
+                                 async::then([hi, lo](auto hi_again) {
+                                     return sample_t{hi, lo, hi_again};
+                                 });
+                      });
+           }) |
+           async::repeat_until(
+               [](sample_t const &s) { return s.hi == s.hi_again; }) |
+           async::then([](sample_t const &s) {
+               return combine_words<Wide, Lo>(s.hi, s.lo);
+           });
+}
+
+template <typename Wide, typename Group, typename Lo, typename Hi>
+auto read_pair(lo_latches_hi) -> async::sender auto {
+    return read_whole<Lo, Group>() | async::let_value([](auto lo) {
+               return read_whole<Hi, Group>() | async::then([lo](auto hi) {
+                          return combine_words<Wide, Lo>(hi, lo);
+                      });
+           });
+}
+
+template <typename Wide, typename Group, typename Lo, typename Hi,
+          stdx::ct_string Path, auto Value>
+auto read_pair(latch_strobe<Path, Value>) -> async::sender auto {
+    return write(Group{}(make_path<Path>() = Value)) |
+           async::let_value([](auto &&...) {
+               return async::when_all(read_whole<Hi, Group>(),
+                                      read_whole<Lo, Group>());
+           }) |
+           async::then([](auto hi, auto lo) {
+               return combine_words<Wide, Lo>(hi, lo);
+           });
+}
+} // namespace detail
+
+// Read a register pair declared with attr::high_word as one value, without
+// tearing when the low word carries into the high word during the read.
+template <typename Group, typename Paths>
+auto read_tear_free(read_spec<Group, Paths> const &) -> async::sender auto {
+    constexpr auto one_register =
+        boost::mp11::mp_size<Paths>::value == 1 and
+        boost::mp11::mp_size<boost::mp11::mp_front<Paths>>::value == 1;
+    if constexpr (not one_register) {
+        STATIC_ASSERT(one_register,
+                      "read_tear_free() reads one register pair: pass only "
+                      "the path of the low register");
+    } else {
+        using P = boost::mp11::mp_front<Paths>;
+        using Lo = get_child<Group, root(P{})>;
+        if constexpr (not detail::low_word_register<Lo>) {
+            STATIC_ASSERT(detail::low_word_register<Lo>,
+                          "Register {} has no attr::high_word for "
+                          "read_tear_free()",
+                          Lo::name);
+        } else {
+            using A = detail::high_word_t<Lo>;
+            using Hi = get_child<Group, A::hi>;
+            using Wide = detail::uint_of_size_t<sizeof(typename Lo::type_t) +
+                                                sizeof(typename Hi::type_t)>;
+            return detail::read_pair<Wide, Group, Lo, Hi>(
+                typename A::sequence_t{});
+        }
+    }
+}
+} // namespace groov
@@ -2,16 +2,34 @@
 
 #define ENABLE_GROOV_TEST
 
+#include <groov/identity.hpp>
 #include <groov/resolve.hpp>
 
 #include <async/concepts.hpp>
 #include <async/just_result_of.hpp>
 
+#include <stdx/bit.hpp>
 #include <stdx/ct_string.hpp>
 #include <stdx/optional.hpp>
 
+#include <boost/mp11/list.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <concepts>
+#include <functional>
+#include <limits>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace groov {
 namespace test {
@@ -81,47 +99,499 @@ template <> struct std::hash<groov::test::detail::value> {
 namespace groov {
 namespace test {
 
+namespace detail {
+// Addresses of any integral or pointer type are looked up as the same key.
+template <typename A> auto to_key(A addr) -> std::uintptr_t {
+    if constexpr (std::is_pointer_v<A>) {
+        return stdx::bit_cast<std::uintptr_t>(addr);
+    } else {
+        return static_cast<std::uintptr_t>(addr);
+    }
+}
+
+// A register value, held in place together with its type.
+class small_value {
+    alignas(std::uint64_t) std::array<std::byte, sizeof(std::uint64_t)>
+        storage{};
+    void const *type{};
+
+  public:
+    small_value() = default;
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    explicit small_value(T const &t) : type{type_id<T>} {
+        static_assert(sizeof(T) <= sizeof(storage),
+                      "A test store value must fit in 64 bits");
+        std::memcpy(storage.data(), std::addressof(t), sizeof(T));
+    }
+
+    template <typename T> auto get() const -> std::optional<T> {
+        if (type != type_id<T>) {
+            return {};
+        }
+        T t;
+        std::memcpy(std::addressof(t), storage.data(), sizeof(T));
+        return t;
+    }
+};
+
+// Each table, and each table again after it is cleared, has a generation of its
+// own: a checkpoint can only be rolled back in the generation it was taken in.
+inline std::atomic<std::size_t> table_generations{};
+
+// An open-addressing hash table keyed by address, with linear probing. Slots
+// are kept across clear(), so a test that resets the store does not allocate.
+//
+// After checkpoint(), the first change to each entry records what the entry
+// was, so that rollback() undoes only what changed since the checkpoint.
+template <typename Entry> class flat_table {
+    struct slot {
+        std::uintptr_t key{};
+        bool used{};
+        // the checkpoint epoch in which the entry was last recorded
+        std::size_t epoch{};
+        Entry entry{};
+    };
+
+    struct undo {
+        std::uintptr_t key{};
+        std::size_t epoch{};
+        std::optional<Entry> entry{};
+    };
+
+    std::vector<slot> slots{};
+    std::size_t count{};
+    std::vector<undo> undo_log{};
+    std::size_t epoch{};
+    std::size_t generation{++table_generations};
+
+    [[nodiscard]] auto home(std::uintptr_t key) const -> std::size_t {
+        // Fibonacci hashing spreads out addresses that differ only in their
+        // low bits
+        constexpr auto multiplier = std::uint64_t{0x9e37'79b9'7f4a'7c15u};
+        auto const h = (static_cast<std::uint64_t>(key) * multiplier) >> 32u;
+        return static_cast<std::size_t>(h) & (slots.size() - 1);
+    }
+
+    auto grow() -> void {
+        auto const size = std::max(std::size_t{16}, slots.size() * 2);
+        auto old = std::exchange(slots, std::vector<slot>(size));
+        for (auto &s : old) {
+            if (s.used) {
+                slots[probe(s.key)] = std::move(s);
+            }
+        }
+    }
+
+    [[nodiscard]] auto probe(std::uintptr_t key) const -> std::size_t {
+        auto i = home(key);
+        while (slots[i].used and slots[i].key != key) {
+            i = (i + 1) & (slots.size() - 1);
+        }
+        return i;
+    }
+
+    auto insert(std::uintptr_t key) -> slot & {
+        // keep the load factor at or below 1/2
+        if (2 * (count + 1) > slots.size()) {
+            grow();
+        }
+        auto &s = slots[probe(key)];
+        s.key = key;
+        s.used = true;
+        ++count;
+        return s;
+    }
+
+    // backward-shift deletion: no tombstones are left behind
+    auto erase(std::uintptr_t key) -> void {
+        auto const mask = slots.size() - 1;
+        auto i = probe(key);
+        slots[i] = slot{};
+        --count;
+        for (auto j = (i + 1) & mask; slots[j].used; j = (j + 1) & mask) {
+            auto const h = home(slots[j].key);
+            // the entry at j may fill the hole at i if its home is not
+            // cyclically within (i, j]
+            if (((j - h) & mask) >= ((j - i) & mask)) {
+                slots[i] = std::exchange(slots[j], slot{});
+                i = j;
+            }
+        }
+    }
+
+  public:
+    struct mark {
+        std::size_t epoch{};
+        std::size_t log_size{};
+        std::size_t generation{};
+    };
+
+    [[nodiscard]] auto find(std::uintptr_t key) -> Entry * {
+        if (count == 0) {
+            return nullptr;
+        }
+        auto &s = slots[probe(key)];
+        return s.used ? std::addressof(s.entry) : nullptr;
+    }
+
+    auto operator[](std::uintptr_t key) -> Entry & {
+        if (count != 0) {
+            if (auto &s = slots[probe(key)]; s.used) {
+                if (s.epoch < epoch) {
+                    undo_log.push_back({key, s.epoch, s.entry});
+                    s.epoch = epoch;
+                }
+                return s.entry;
+            }
+        }
+        if (epoch != 0) {
+            undo_log.push_back({key, 0, std::nullopt});
+        }
+        auto &s = insert(key);
+        s.epoch = epoch;
+        return s.entry;
+    }
+
+    auto clear() -> void {
+        for (auto &s : slots) {
+            s = slot{};
+        }
+        count = 0;
+        undo_log.clear();
+        epoch = 0;
+        generation = ++table_generations;
+    }
+
+    [[nodiscard]] auto checkpoint() -> mark {
+        return {++epoch, undo_log.size(), generation};
+    }
+
+    // Undo every change made since the checkpoint. Checkpoints taken after
+    // it can no longer be rolled back to, and neither can one taken of
+    // another table, or of this one before it was cleared.
+    auto rollback(mark m) -> void {
+        assert(m.generation == generation);
+        if (m.generation != generation) {
+            return;
+        }
+        while (undo_log.size() > m.log_size) {
+            auto &u = undo_log.back();
+            if (u.entry) {
+                auto &s = slots[probe(u.key)];
+                s.entry = std::move(*u.entry);
+                s.epoch = u.epoch;
+            } else {
+                erase(u.key);
+            }
+            undo_log.pop_back();
+        }
+    }
+};
+
+// The callbacks see type-erased values; a plain register value is kept in
+// place.
+struct store_entry {
+    std::function<void(detail::value, detail::value)> write_function;
+    std::function<detail::value(detail::value)> read_function;
+    small_value value{};
+};
+
+using store_table = flat_table<store_entry>;
+
+// How the bits of a register respond to a write. A bit in set_mask becomes 1
+// when it is written with its bit of set_value, and a bit in clear_mask
+// becomes 0 when it is written with its bit of clear_value; any other bit
+// keeps its value.
+template <typename T> struct write_model {
+    T set_mask{};
+    T set_value{};
+    T clear_mask{};
+    T clear_value{};
+
+    [[nodiscard]] constexpr auto apply(T prev, T mask, T bits) const -> T {
+        auto const set = static_cast<T>(~(bits ^ set_value) & set_mask);
+        auto const clear =
+            static_cast<T>(~(bits ^ clear_value) & clear_mask & ~set);
+        auto const next = static_cast<T>((prev | set) & ~clear);
+        // a bit written as 1 outside the mask is written all the same
+        auto const written = static_cast<T>(mask | bits);
+        return static_cast<T>((prev & ~written) | (next & written));
+    }
+
+    friend constexpr auto operator|(write_model const &x,
+                                    write_model const &y) -> write_model {
+        return {static_cast<T>(x.set_mask | y.set_mask),
+                static_cast<T>(x.set_value | y.set_value),
+                static_cast<T>(x.clear_mask | y.clear_mask),
+                static_cast<T>(x.clear_value | y.clear_value)};
+    }
+};
+
+// Every bit is stored as it is written.
+template <typename T>
+constexpr auto replace_model =
+    write_model<T>{std::numeric_limits<T>::max(), std::numeric_limits<T>::max(),
+                   std::numeric_limits<T>::max(), T{}};
+
+// A read-only node, or one written with w::ignore, does not change when it is
+// written.
+template <typename W>
+concept ignored_write_function =
+    read_only_write_function<W> or
+    (identity_write_function<W> and std::same_as<typename W::id_spec, m::any>);
+
+template <write_function W, typename T, T Mask>
+constexpr auto node_write_model() -> write_model<T> {
+    auto model = write_model<T>{};
+    if constexpr (not ignored_write_function<W>) {
+        if constexpr (set_write_function<W>) {
+            model.set_mask = Mask;
+            model.set_value = W::set_spec::template mask<Mask>();
+        }
+        if constexpr (clear_write_function<W>) {
+            model.clear_mask = Mask;
+            model.clear_value = W::clear_spec::template mask<Mask>();
+        }
+    }
+    return model;
+}
+
+// Each field of a register behaves as its write function says; the bits that
+// are not in any field behave as the register's write function says.
+template <typename Register, typename T>
+constexpr auto register_write_model() -> write_model<T> {
+    constexpr auto unused = static_cast<T>(Register::template mask<T> &
+                                           ~Register::children_mask);
+    return [&]<typename... Fs>(boost::mp11::mp_list<Fs...>) {
+        return (node_write_model<typename Register::write_fn_t, T, unused>() |
+                ... |
+                node_write_model<typename Fs::write_fn_t, T,
+                                 Fs::template mask<T>>());
+    }(typename Register::children_t{});
+}
+
+// One stripe of a concurrent store, on its own cache line so that threads
+// using different stripes do not contend.
+struct alignas(64) store_shard {
+    std::mutex mutex{};
+    store_table table{};
+};
+
+constexpr auto num_store_shards = std::size_t{16};
+
+struct no_lock {
+    constexpr auto unlock() -> void {}
+};
+
+constexpr auto shard_of(std::uintptr_t key) -> std::size_t {
+    // registers are usually word-aligned: ignore the low bits
+    return (key >> 2u) % num_store_shards;
+}
+} // namespace detail
+
+// Specialize this to true for a group whose store is used from several
+// threads at once. The store is then split into shards by address, each with
+// its own lock.
+template <stdx::ct_string Group> constexpr auto concurrent_store = false;
+
+template <typename Group> class isolated_store;
+template <stdx::ct_string Group> struct store;
+
+// The state of a group's store at some point, to roll back to
+template <stdx::ct_string Group> class store_checkpoint {
+    friend struct store<Group>;
+    // a concurrent store has a mark for each shard; otherwise the mark is of
+    // the table the thread saw, which is found again to roll back
+    bool sharded{};
+    std::array<detail::store_table::mark, detail::num_store_shards> marks{};
+};
+
 template <stdx::ct_string Group> struct store {
-    static auto reset() { state.clear(); }
+    static auto reset() {
+        if (num_isolated != 0 and local != nullptr) {
+            local->clear();
+        } else if constexpr (concurrent_store<Group>) {
+            for (auto &shard : shards) {
+                std::lock_guard lock{shard.mutex};
+                shard.table.clear();
+            }
+        } else {
+            state.clear();
+        }
+    }
 
-    static void set_value(auto addr, auto value) {
-        auto &entry = state[addr];
-        if (entry.write_function) {
-            entry.write_function(addr, value);
+    // After a checkpoint, the store records the first change to each
+    // register, so that rolling back costs only as much as what changed.
+    //
+    // A checkpoint may only be rolled back to while the store it was taken of
+    // is still the one in use: not after reset(), and not once the
+    // isolated_store it was taken under has gone. This is asserted.
+    [[nodiscard]] static auto checkpoint() -> store_checkpoint<Group> {
+        auto cp = store_checkpoint<Group>{};
+        if (auto *table = unsharded_table(); table != nullptr) {
+            cp.marks[0] = table->checkpoint();
         } else {
-            entry.value = value;
+            cp.sharded = true;
+            for (auto i = std::size_t{}; i < shards.size(); ++i) {
+                std::lock_guard lock{shards[i].mutex};
+                cp.marks[i] = shards[i].table.checkpoint();
+            }
         }
+        return cp;
     }
 
-    template <typename T> static auto get_value(auto addr) -> std::optional<T> {
-        auto &entry = state[addr];
-        if (entry.read_function) {
-            return entry.read_function(addr).template get<T>();
+    static auto rollback(store_checkpoint<Group> const &cp) -> void {
+        if (auto *table = unsharded_table(); table != nullptr) {
+            assert(not cp.sharded);
+            table->rollback(cp.marks[0]);
         } else {
-            if (entry.value) {
-                return entry.value->template get<T>();
+            assert(cp.sharded);
+            for (auto i = std::size_t{}; i < shards.size(); ++i) {
+                std::lock_guard lock{shards[i].mutex};
+                shards[i].table.rollback(cp.marks[i]);
+            }
+        }
+    }
+
+    static void set_value(auto addr, auto value) {
+        auto const key = detail::to_key(addr);
+        access(key, [&](auto &table, auto &lock) {
+            auto &entry = table[key];
+            if (entry.write_function) {
+                auto write_function = entry.write_function;
+                lock.unlock();
+                write_function(addr, value);
             } else {
-                return {};
+                entry.value = detail::small_value{value};
+            }
+        });
+    }
+
+    // Write the bits under mask to a register as the bus does: the previous
+    // value is updated according to the model, in place. A read function
+    // supplies the previous value; a write function is called instead of
+    // storing anything, and is passed the written bits merged into the
+    // previous value.
+    template <typename T>
+    static void write(auto addr, T mask, T bits,
+                      detail::write_model<T> const &model) {
+        auto const key = detail::to_key(addr);
+        auto const stored = access(key, [&](auto &table, auto &) {
+            auto &entry = table[key];
+            if (entry.write_function or entry.read_function) {
+                return false;
             }
+            auto const prev = entry.value.template get<T>().value_or(T{});
+            entry.value = detail::small_value{model.apply(prev, mask, bits)};
+            return true;
+        });
+        if (not stored) {
+            auto const prev = get_value<T>(addr).value_or(T{});
+            auto const has_write_function =
+                access(key, [&](auto &table, auto &) {
+                    auto const entry = table.find(key);
+                    return entry != nullptr and
+                           static_cast<bool>(entry->write_function);
+                });
+            set_value(addr, has_write_function
+                                ? static_cast<T>((prev & ~mask) | bits)
+                                : model.apply(prev, mask, bits));
         }
     }
 
+    template <typename T> static auto get_value(auto addr) -> std::optional<T> {
+        auto const key = detail::to_key(addr);
+        return access(key, [&](auto &table, auto &lock) -> std::optional<T> {
+            auto const entry = table.find(key);
+            if (entry == nullptr) {
+                return {};
+            }
+            if (entry->read_function) {
+                auto read_function = entry->read_function;
+                lock.unlock();
+                return read_function(addr).template get<T>();
+            }
+            return entry->value.template get<T>();
+        });
+    }
+
     template <typename F> static auto set_write_function(auto addr, F &&f) {
-        return state[addr].write_function = std::forward<F>(f);
+        auto const key = detail::to_key(addr);
+        access(key, [&](auto &table, auto &) {
+            table[key].write_function = std::forward<F>(f);
+        });
     }
 
     template <typename F> static auto set_read_function(auto addr, F &&f) {
-        return state[addr].read_function = std::forward<F>(f);
+        auto const key = detail::to_key(addr);
+        access(key, [&](auto &table, auto &) {
+            table[key].read_function = std::forward<F>(f);
+        });
     }
 
   private:
-    struct store_value_t {
-        std::function<void(detail::value, detail::value)> write_function;
-        std::function<detail::value(detail::value)> read_function;
-        std::optional<detail::value> value{};
-    };
+    template <typename> friend class isolated_store;
+
+    // the table the current thread sees, or null for the shards of a
+    // concurrent store
+    static auto unsharded_table() -> detail::store_table * {
+        if (num_isolated != 0 and local != nullptr) {
+            return local;
+        }
+        if constexpr (concurrent_store<Group>) {
+            return nullptr;
+        } else {
+            return std::addressof(state);
+        }
+    }
+
+    // Callbacks are called after unlocking, so that they may use the store.
+    template <typename F> static auto access(std::uintptr_t key, F &&f) {
+        // looking up the thread's own store is only worth it when there is
+        // one somewhere
+        auto const isolated =
+            num_isolated.load(std::memory_order_relaxed) != 0 ? local : nullptr;
+        if constexpr (concurrent_store<Group>) {
+            if (isolated == nullptr) {
+                auto &shard = shards[detail::shard_of(key)];
+                auto lock = std::unique_lock{shard.mutex};
+                return std::forward<F>(f)(shard.table, lock);
+            }
+        }
+        auto lock = detail::no_lock{};
+        return std::forward<F>(f)(isolated != nullptr ? *isolated : state,
+                                  lock);
+    }
+
+    static inline detail::store_table state{};
+    static inline std::array<detail::store_shard, detail::num_store_shards>
+        shards{};
+    static inline thread_local detail::store_table *local{};
+    static inline std::atomic<int> num_isolated{};
+};
+
+// While this is alive, the current thread has a store of its own for the
+// group, which starts empty; other threads are unaffected. Guards may nest.
+template <typename Group> class [[nodiscard]] isolated_store {
+    using store_t = store<Group::name>;
+    detail::store_table table{};
+    detail::store_table *previous{};
 
-    static inline std::unordered_map<detail::value, store_value_t> state{};
+  public:
+    isolated_store() : previous{std::exchange(store_t::local, &table)} {
+        ++store_t::num_isolated;
+    }
+    explicit isolated_store(Group) : isolated_store{} {}
+
+    isolated_store(isolated_store const &) = delete;
+    auto operator=(isolated_store const &) -> isolated_store & = delete;
+
+    ~isolated_store() {
+        store_t::local = previous;
+        --store_t::num_isolated;
+    }
 };
 
 namespace detail {
@@ -138,6 +608,19 @@ template <typename Group> void reset_store() { store<Group::name>::reset(); }
 
 template <typename Group> void reset_store(Group) { reset_store<Group>(); }
 
+template <typename Group> [[nodiscard]] auto checkpoint() {
+    return store<Group::name>::checkpoint();
+}
+
+template <typename Group> [[nodiscard]] auto checkpoint(Group) {
+    return checkpoint<Group>();
+}
+
+template <stdx::ct_string Group>
+void rollback(store_checkpoint<Group> const &cp) {
+    store<Group>::rollback(cp);
+}
+
 template <typename Group, pathlike P, typename V> void set_value(P p, V value) {
     using Store = store<Group::name>;
     using Reg = decltype(Group::resolve(p));
@@ -224,28 +707,54 @@ struct optional_policy {
     }
 };
 
+namespace detail {
+// What a test bus does for a read or a write, once it does it
+template <stdx::ct_string Group, typename XPolicy, stdx::ct_string RegName,
+          auto Mask>
+auto read_store(auto addr) {
+    using T = decltype(Mask);
+    return XPolicy{}.template operator()<RegName, Mask>(
+        addr, store<Group>::template get_value<T>(addr));
+}
+
+template <stdx::ct_string Group, auto Model, auto Mask, auto IdMask,
+          auto IdValue>
+auto write_store(auto addr, auto val) -> void {
+    using T = decltype(Mask);
+    constexpr auto mask = static_cast<T>(Mask | IdMask);
+    auto const write_bits = static_cast<T>(val | IdValue);
+    store<Group>::write(addr, mask, write_bits, Model);
+}
+} // namespace detail
+
 template <stdx::ct_string Group, typename XPolicy = optional_policy>
 struct bus {
     template <stdx::ct_string RegName, auto Mask>
     static auto read(auto addr) -> async::sender auto {
-        using T = decltype(Mask);
         return async::just_result_of([=] {
-            return XPolicy{}.template operator()<RegName, Mask>(
-                addr, [&]() -> std::optional<T> {
-                    return store<Group>::template get_value<T>(addr);
-                }());
+            return detail::read_store<Group, XPolicy, RegName, Mask>(addr);
         });
     }
 
+    // Without the register, every bit is taken to be written with w::replace.
     template <stdx::ct_string, auto Mask, auto IdMask, auto IdValue>
     static auto write(auto addr, auto val) -> async::sender auto {
         using T = decltype(Mask);
         return async::just_result_of([=]() -> void {
-            constexpr T mask = Mask | IdMask;
-            T write_bits = val | IdValue;
+            detail::write_store<Group, detail::replace_model<T>, Mask, IdMask,
+                                IdValue>(addr, val);
+        });
+    }
 
-            auto prev = store<Group>::template get_value<T>(addr).value_or(T{});
-            store<Group>::set_value(addr, (prev & ~mask) | write_bits);
+    // Each field behaves as its write function says: for instance, writing 1
+    // to a w::one_to_clear field clears it.
+    template <typename Register, auto Mask, auto IdMask, auto IdValue>
+    static auto write_register(auto addr, auto val) -> async::sender auto {
+        using T = decltype(Mask);
+        return async::just_result_of([=]() -> void {
+            detail::write_store<Group,
+                                detail::register_write_model<Register, T>(),
+                                Mask, IdMask, IdValue>(addr, val);
         });
     }
 };
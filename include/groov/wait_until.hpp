@@ -0,0 +1,173 @@
+#pragma once
+
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+
+#include <async/compose.hpp>
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+#include <async/just_result_of.hpp>
+#include <async/let_value.hpp>
+#include <async/repeat.hpp>
+#include <async/then.hpp>
+#include <async/variant_sender.hpp>
+
+#include <stdx/concepts.hpp>
+#include <stdx/utility.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace groov {
+// The error sent by wait_until when its deadline passes first.
+struct wait_timeout {};
+
+// Polling strategies: pause() returns a sender that runs before each read.
+
+// re-read immediately
+struct spin {
+    [[nodiscard]] static auto pause() -> async::sender auto {
+        return async::just();
+    }
+};
+
+// busy-wait between reads, doubling the wait each time up to Max iterations
+template <std::size_t Initial = 1, std::size_t Max = 1024> struct backoff {
+    static_assert(0 < Initial and Initial <= Max,
+                  "backoff needs 0 < Initial <= Max");
+
+    std::size_t iterations{};
+
+    [[nodiscard]] auto pause() -> async::sender auto {
+        return async::just_result_of([this]() -> void {
+            for (auto i = std::size_t{}; i < iterations; ++i) {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+                asm volatile("yield");
+#endif
+            }
+            iterations =
+                iterations == 0 ? Initial : std::min(iterations * 2, Max);
+        });
+    }
+};
+
+// hand the core to a scheduler between reads
+template <typename Scheduler> struct yield_to {
+    Scheduler scheduler{};
+
+    [[nodiscard]] auto pause() -> async::sender auto {
+        return scheduler.schedule();
+    }
+};
+
+// the default: poll until the predicate is satisfied, however long it takes
+struct no_deadline {};
+
+namespace detail {
+template <typename T>
+concept wait_strategy = requires(T &t) {
+    { t.pause() } -> async::sender;
+};
+
+template <typename T>
+concept wait_deadline =
+    std::same_as<T, no_deadline> or requires(T const &t) {
+        { T::clock::now() >= t } -> std::convertible_to<bool>;
+    };
+
+template <typename Strategy, typename Deadline> struct poll_state {
+    Strategy strategy;
+    Deadline deadline;
+
+    [[nodiscard]] auto expired() const -> bool {
+        if constexpr (std::is_same_v<Deadline, no_deadline>) {
+            return false;
+        } else {
+            return Deadline::clock::now() >= deadline;
+        }
+    }
+};
+
+template <typename T> struct poll_result {
+    T value;
+    bool satisfied;
+    bool expired;
+};
+
+template <typename T, typename Group, typename Paths, typename Pred,
+          typename Strategy, typename Deadline>
+auto wait_until(read_spec<Group, Paths> const &s, Pred pred, Strategy strategy,
+                Deadline deadline) -> async::sender auto {
+    using state_t = poll_state<Strategy, Deadline>;
+    return async::just(state_t{std::move(strategy), deadline}) |
+           async::let_value([s, pred = std::move(pred)](state_t &st) {
+               return st.strategy.pause() |
+                      async::let_value([s] { return read_as<T>(s); }) |
+                      async::then([&st, pred]<typename V>(V &&v) {
+                          auto const satisfied = static_cast<bool>(pred(v));
+                          return poll_result<std::remove_cvref_t<V>>{
+                              std::forward<V>(v), satisfied,
+                              not satisfied and st.expired()};
+                      }) |
+                      async::repeat_until([](auto const &r) {
+                          return r.satisfied or r.expired;
+                      }) |
+                      async::let_value([](auto const &r) {
+                          return async::make_variant_sender(
+                              r.satisfied,
+                              [&] { return async::just(r.value); },
+                              [] { return async::just_error(wait_timeout{}); });
+                      });
+           });
+}
+} // namespace detail
+
+// Repeatedly read s until pred is satisfied by what was read, then send that.
+// Only the registers in s are read, and strategy decides what happens between
+// reads. If the deadline passes first, wait_timeout is sent as an error.
+template <typename T = void, typename Group, typename Paths, typename Pred,
+          detail::wait_strategy Strategy = spin,
+          detail::wait_deadline Deadline = no_deadline>
+auto wait_until(read_spec<Group, Paths> const &s, Pred &&pred,
+                Strategy strategy = {}, Deadline deadline = {})
+    -> async::sender auto {
+    return detail::wait_until<T>(s, std::forward<Pred>(pred),
+                                 std::move(strategy), deadline);
+}
+
+namespace _wait_until {
+template <typename T, typename Pred, typename Strategy, typename Deadline>
+struct pipeable {
+    Pred pred;
+    Strategy strategy;
+    Deadline deadline;
+
+  private:
+    template <async::sender S, stdx::same_as_unqualified<pipeable> P>
+    friend constexpr auto operator|(S &&s, P &&p) -> async::sender auto {
+        return std::forward<S>(s) |
+               async::let_value([p = std::forward<P>(p)](auto &&spec) {
+                   return groov::wait_until<T>(FWD(spec), p.pred,
+                                               p.strategy, p.deadline);
+               });
+    }
+};
+} // namespace _wait_until
+
+template <typename T = void, typename Pred,
+          detail::wait_strategy Strategy = spin,
+          detail::wait_deadline Deadline = no_deadline>
+    requires(not detail::wait_strategy<Pred>)
+constexpr auto wait_until(Pred &&pred, Strategy strategy = {},
+                          Deadline deadline = {}) {
+    return async::compose(
+        _wait_until::pipeable<T, std::decay_t<Pred>, Strategy, Deadline>{
+            std::forward<Pred>(pred), std::move(strategy), deadline});
+}
+} // namespace groov
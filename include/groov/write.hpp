@@ -1,12 +1,17 @@
 #pragma once
 
+#include <groov/alias.hpp>
+#include <groov/coalesce.hpp>
 #include <groov/config.hpp>
 #include <groov/identity.hpp>
+#include <groov/plan.hpp>
+#include <groov/shadow.hpp>
 
 #include <async/concepts.hpp>
 #include <async/just.hpp>
 #include <async/let_value.hpp>
 #include <async/sync_wait.hpp>
+#include <async/then.hpp>
 #include <async/when_all.hpp>
 
 #include <stdx/compiler.hpp>
@@ -16,24 +21,200 @@
 #include <stdx/tuple_algorithms.hpp>
 
 #include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/list.hpp>
 
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
 namespace groov {
+// A write policy that limits the number of loads a write may make on the bus,
+// counting each read-modify-write as one load. A write that would exceed the
+// limit fails to compile.
+template <std::size_t N = std::numeric_limits<std::size_t>::max()>
+struct max_loads {
+    constexpr static std::size_t limit = N;
+};
+using no_rmw = max_loads<0>;
+
 namespace detail {
+template <typename T>
+concept write_policy = requires {
+    { T::limit } -> std::convertible_to<std::size_t>;
+};
+
+template <typename T>
+concept sync_behavior =
+    std::same_as<T, blocking> or std::same_as<T, non_blocking>;
+
 template <typename Register, typename Bus, auto Mask, auto IdMask, auto IdValue,
           typename V>
-auto write(V value) -> async::sender auto {
+auto write(V value, std::size_t index = 0) -> async::sender auto {
     constexpr auto write_mask = transform_mask<Bus>(Mask);
     constexpr auto id_mask = write_mask & IdMask;
-    STATIC_ASSERT(write_mask == (Mask | id_mask) or
+    constexpr auto needs_rmw = write_mask != (Mask | id_mask);
+    constexpr auto aliased = writes_through_aliases<Register, Mask>;
+    STATIC_ASSERT(not needs_rmw or aliased or
                       not is_write_only<Register>::value,
                   "Write to register {} would incur RMW on write-only bits",
                   Register::name);
 
-    return Bus::template write<Register::name, Mask, id_mask, IdValue>(
-        get_address<Register>(), value);
+    if constexpr (needs_rmw and aliased) {
+        if constexpr (shadowed_register<Register>) {
+            return write_aliased<Register, Bus, Mask>(value) |
+                   async::then([=] {
+                       update_shadow<Bus, Register, Mask, id_mask>(value);
+                   });
+        } else {
+            return write_aliased<Register, Bus, Mask>(value);
+        }
+    } else if constexpr (shadowed_register<Register>) {
+        return write_shadowed<Register, Bus, Mask, id_mask, IdValue>(value);
+    } else {
+        return bus_write<Register, Bus, Mask, id_mask, IdValue>(
+            element_address<Register>(index), value);
+    }
+}
+
+template <typename Register, typename Mask, typename IdMask, typename IdValue>
+struct register_write {
+    using register_t = Register;
+    constexpr static auto mask = Mask::value;
+    constexpr static auto id_mask = IdMask::value;
+    constexpr static auto id_value = IdValue::value;
+
+    constexpr static auto address = constant_address<Register>();
+    constexpr static bool coalescable =
+        constant_addressed<Register> and not register_array<Register> and
+        (mask | id_mask) == std::numeric_limits<decltype(mask)>::max();
+};
+
+template <typename... Ws> struct coalesced_write {
+    using first_t = boost::mp11::mp_front<boost::mp11::mp_list<Ws...>>;
+    using register_t = typename first_t::register_t;
+    constexpr static auto base = first_t::address;
+    using wide_t = coalesced_t<Ws...>;
+
+    constexpr static auto mask =
+        (wide_t{} | ... | to_lane<wide_t, base, Ws>(Ws::mask));
+    constexpr static auto id_mask =
+        (wide_t{} | ... | to_lane<wide_t, base, Ws>(Ws::id_mask));
+    constexpr static auto id_value =
+        (wide_t{} | ... | to_lane<wide_t, base, Ws>(Ws::id_value));
+};
+
+template <typename Bus, typename... Ws>
+auto write_coalesced(typename Ws::register_t::type_t... values)
+    -> async::sender auto {
+    using C = coalesced_write<Ws...>;
+    using wide_t = typename C::wide_t;
+    auto const value =
+        (wide_t{} | ... | to_lane<wide_t, C::base, Ws>(values));
+
+    auto s = Bus::template write<C::register_t::name, C::mask, C::id_mask,
+                                 C::id_value>(
+        get_address<typename C::register_t>(), value);
+    if constexpr ((... or shadowed_register<typename Ws::register_t>)) {
+        return std::move(s) | async::then([=] {
+                   (update_shadow<Bus, typename Ws::register_t, Ws::mask,
+                                  Ws::id_mask>(values),
+                    ...);
+               });
+    } else {
+        return s;
+    }
+}
+
+template <typename Bus, typename Writes, auto Plan, std::size_t Run>
+auto write_run(auto const &spec) -> async::sender auto {
+    auto const &values = spec.value;
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        if constexpr (sizeof...(Is) == 1) {
+            constexpr auto idx = Plan.order[Plan.first[Run]];
+            using W = boost::mp11::mp_at_c<Writes, idx>;
+            return write<typename W::register_t, Bus, W::mask, W::id_mask,
+                         W::id_value>(stdx::get<idx>(values).value,
+                                      spec.index);
+        } else {
+            return write_coalesced<
+                Bus, boost::mp11::mp_at_c<
+                         Writes, Plan.order[Plan.first[Run] + Is]>...>(
+                stdx::get<Plan.order[Plan.first[Run] + Is]>(values).value...);
+        }
+    }(std::make_index_sequence<Plan.length[Run]>{});
+}
+
+template <typename Bus, typename Writes, auto Plan>
+auto write_runs(auto const &spec) -> async::sender auto {
+    return [&]<std::size_t... Runs>(std::index_sequence<Runs...>) {
+        return async::when_all(write_run<Bus, Writes, Plan, Runs>(spec)...);
+    }(std::make_index_sequence<Plan.num_runs>{});
+}
+
+// As write_runs, but each run starts only when the one before it has
+// completed, so the bus sees the writes in the order of the spec.
+template <typename Bus, typename Writes, auto Plan, std::size_t Run = 0>
+auto write_runs_in_order(auto const &spec) -> async::sender auto {
+    auto s = write_run<Bus, Writes, Plan, Run>(spec);
+    if constexpr (Run + 1 == Plan.num_runs) {
+        return s;
+    } else {
+        return std::move(s) | async::let_value([=] {
+                   return write_runs_in_order<Bus, Writes, Plan, Run + 1>(
+                       spec);
+               });
+    }
+}
+
+// The accesses that write<Register, Bus, Mask, IdMask, IdValue> will make,
+// following the same routing. A partial write to a shadowed register is
+// planned for the worst case, when the shadow is not valid.
+template <typename Register, typename Bus, auto Mask, auto IdMask>
+consteval auto plan_register_write() {
+    constexpr auto write_mask = transform_mask<Bus>(Mask);
+    constexpr auto id_mask = write_mask & IdMask;
+    constexpr auto needs_rmw = write_mask != (Mask | id_mask);
+
+    constexpr auto name = static_cast<std::string_view>(Register::name);
+    constexpr auto addr = constant_address<Register>();
+
+    if constexpr (needs_rmw and writes_through_aliases<Register, Mask>) {
+        // a single-bit write goes to either alias: the set alias is reported
+        using A = set_clear_aliases_t<Register>;
+        using T = decltype(Mask);
+        constexpr auto set =
+            plan_write<Bus, Mask, static_cast<T>(~Mask)>(
+                name, addr + A::set_offset);
+        if constexpr (std::has_single_bit(Mask)) {
+            return set;
+        } else {
+            return concat(plan_write<Bus, Mask, static_cast<T>(~Mask)>(
+                              name, addr + A::clear_offset),
+                          set);
+        }
+    } else {
+        return plan_write<Bus, Mask, id_mask>(name, addr);
+    }
+}
+
+template <typename Bus, typename Writes, auto Plan, std::size_t Run>
+consteval auto plan_run() {
+    return []<std::size_t... Is>(std::index_sequence<Is...>) {
+        if constexpr (sizeof...(Is) == 1) {
+            using W = boost::mp11::mp_at_c<Writes, Plan.order[Plan.first[Run]]>;
+            return plan_register_write<typename W::register_t, Bus, W::mask,
+                                       W::id_mask>();
+        } else {
+            using C = coalesced_write<boost::mp11::mp_at_c<
+                Writes, Plan.order[Plan.first[Run] + Is]>...>;
+            return plan_write<Bus, C::mask, C::id_mask>(
+                static_cast<std::string_view>(C::register_t::name), C::base);
+        }
+    }(std::make_index_sequence<Plan.length[Run]>{});
 }
 
 template <typename Reg, typename ObjList>
@@ -97,80 +278,182 @@ consteval auto check_rmw() -> void {
 template <typename T>
 concept write_spec_like =
     requires { typename std::remove_cvref_t<T>::is_write_spec; };
-} // namespace detail
 
-template <detail::write_spec_like Spec>
-auto write(Spec const &s) -> async::sender auto {
-    using fields_per_reg_t = boost::mp11::mp_transform_q<
-        detail::fields_for_reg_q<typename Spec::paths_t>,
-        typename Spec::value_t>;
+template <typename Spec> struct write_traits {
+    using bus_t = typename Spec::bus_t;
+
+    using fields_per_reg_t =
+        boost::mp11::mp_transform_q<fields_for_reg_q<typename Spec::paths_t>,
+                                    typename Spec::value_t>;
 
     using written_fields_per_reg_t =
-        boost::mp11::mp_transform<detail::all_fields_t, fields_per_reg_t>;
+        boost::mp11::mp_transform<all_fields_t, fields_per_reg_t>;
 
     using all_fields_per_reg_t = boost::mp11::mp_transform<
-        detail::all_fields_t,
-        boost::mp11::mp_transform<boost::mp11::mp_list,
-                                  typename Spec::value_t>>;
+        all_fields_t, boost::mp11::mp_transform<boost::mp11::mp_list,
+                                                typename Spec::value_t>>;
 
     using unwritten_fields_per_reg_t =
         boost::mp11::mp_transform<boost::mp11::mp_set_difference,
                                   all_fields_per_reg_t,
                                   written_fields_per_reg_t>;
 
-    using field_masks_t = boost::mp11::mp_transform<detail::compute_mask_t,
-                                                    typename Spec::value_t,
-                                                    written_fields_per_reg_t>;
-
-    detail::check_read_only<typename Spec::bus_t, fields_per_reg_t>();
-    detail::check_rmw<typename Spec::bus_t, unwritten_fields_per_reg_t,
-                      field_masks_t>();
+    using field_masks_t =
+        boost::mp11::mp_transform<compute_mask_t, typename Spec::value_t,
+                                  written_fields_per_reg_t>;
 
     using identity_masks_t =
-        boost::mp11::mp_transform<detail::compute_id_mask_t,
-                                  typename Spec::value_t,
+        boost::mp11::mp_transform<compute_id_mask_t, typename Spec::value_t,
                                   unwritten_fields_per_reg_t>;
 
     using identity_values_t =
-        boost::mp11::mp_transform<detail::compute_id_value_t,
-                                  typename Spec::value_t,
+        boost::mp11::mp_transform<compute_id_value_t, typename Spec::value_t,
                                   unwritten_fields_per_reg_t>;
 
     using reg_identity_masks_t =
-        boost::mp11::mp_transform<detail::compute_reg_id_mask_t,
+        boost::mp11::mp_transform<compute_reg_id_mask_t,
                                   typename Spec::value_t>;
     using reg_identity_values_t =
-        boost::mp11::mp_transform<detail::compute_reg_id_value_t,
+        boost::mp11::mp_transform<compute_reg_id_value_t,
                                   typename Spec::value_t>;
 
-    return stdx::transform(
-               []<typename R, typename Mask, typename IdMask, typename IdValue,
-                  typename RegIdMask, typename RegIdValue>(
-                   R const &r, Mask, IdMask, IdValue, RegIdMask, RegIdValue) {
-                   return detail::write<R, typename Spec::bus_t, Mask::value,
-                                        (IdMask::value | RegIdMask::value),
-                                        (IdValue::value | RegIdValue::value)>(
-                       r.value);
-               },
-               s.value, field_masks_t{}, identity_masks_t{},
-               identity_values_t{}, reg_identity_masks_t{},
-               reg_identity_values_t{})
-        .apply([]<typename... Ws>(Ws &&...ws) {
-            return async::when_all(std::forward<Ws>(ws)...);
-        });
-}
-
-template <detail::write_spec_like Spec, typename... Args>
+    using writes_t = boost::mp11::mp_transform<
+        register_write, typename Spec::value_t, field_masks_t,
+        boost::mp11::mp_transform<bitwise_or_t, identity_masks_t,
+                                  reg_identity_masks_t>,
+        boost::mp11::mp_transform<bitwise_or_t, identity_values_t,
+                                  reg_identity_values_t>>;
+
+    constexpr static auto plan = plan_coalesce<bus_t>(
+        boost::mp11::mp_rename<writes_t, boost::mp11::mp_list>{});
+
+    consteval static auto accesses() {
+        return []<std::size_t... Runs>(std::index_sequence<Runs...>) {
+            return concat(plan_run<bus_t, writes_t, plan, Runs>()...);
+        }(std::make_index_sequence<plan.num_runs>{});
+    }
+};
+
+template <typename R, typename F, auto Preserved>
+consteval auto check_load_field() -> void {
+    STATIC_ASSERT((F::template mask<decltype(Preserved)> & Preserved) ==
+                      decltype(Preserved){},
+                  "Write to register {} would incur a load to preserve field "
+                  "{}",
+                  R::name, F::name);
+}
+
+template <typename Bus, typename W, typename... Fs>
+consteval auto check_no_loads(boost::mp11::mp_list<Fs...>) -> void {
+    using R = typename W::register_t;
+    using T = decltype(W::mask);
+    constexpr auto p = plan_register_write<R, Bus, W::mask, W::id_mask>();
+    if constexpr (p.num_loads() != 0) {
+        constexpr auto preserved = static_cast<T>(transform_mask<Bus>(W::mask) &
+                                                  ~(W::mask | W::id_mask));
+        if constexpr ((... or
+                       ((Fs::template mask<T> & preserved) != T{}))) {
+            (check_load_field<R, Fs, preserved>(), ...);
+        } else {
+            STATIC_ASSERT(p.num_loads() == 0,
+                          "Write to register {} would incur a load", R::name);
+        }
+    }
+}
+
+template <typename R, typename F>
+consteval auto check_read_effect_field() -> void {
+    STATIC_ASSERT(not has_read_effect<F>::value,
+                  "Write to register {} would load {}, which has side effects "
+                  "on read",
+                  R::name, F::name);
+}
+
+template <typename Bus, typename W> consteval auto check_hidden_read() -> void {
+    using R = typename W::register_t;
+    if constexpr (has_read_effects<R>) {
+        constexpr auto p = plan_register_write<R, Bus, W::mask, W::id_mask>();
+        if constexpr (p.num_loads() != 0) {
+            []<typename... Fs>(boost::mp11::mp_list<Fs...>) {
+                (check_read_effect_field<R, Fs>(), ...);
+            }(read_effects_t<R>{});
+        }
+    }
+}
+
+template <typename Traits> consteval auto check_read_effects() -> void {
+    []<typename... Ws>(boost::mp11::mp_list<Ws...>) {
+        (check_hidden_read<typename Traits::bus_t, Ws>(), ...);
+    }(boost::mp11::mp_rename<typename Traits::writes_t,
+                             boost::mp11::mp_list>{});
+}
+
+template <typename Policy, typename Traits>
+consteval auto check_loads() -> void {
+    if constexpr (Policy::limit != std::numeric_limits<std::size_t>::max()) {
+        constexpr auto loads = Traits::accesses().num_loads();
+        if constexpr (Policy::limit == 0 and loads != 0) {
+            []<typename... Ws, typename... Fs>(boost::mp11::mp_list<Ws...>,
+                                               boost::mp11::mp_list<Fs...>) {
+                (check_no_loads<typename Traits::bus_t, Ws>(
+                     boost::mp11::mp_rename<Fs, boost::mp11::mp_list>{}),
+                 ...);
+            }(boost::mp11::mp_rename<typename Traits::writes_t,
+                                     boost::mp11::mp_list>{},
+              boost::mp11::mp_rename<
+                  typename Traits::unwritten_fields_per_reg_t,
+                  boost::mp11::mp_list>{});
+        } else {
+            STATIC_ASSERT(loads <= Policy::limit,
+                          "Write would exceed its budget of bus loads");
+        }
+    }
+}
+
+template <typename Policy, typename Traits>
+consteval auto check_write() -> void {
+    using bus_t = typename Traits::bus_t;
+    check_read_only<bus_t, typename Traits::fields_per_reg_t>();
+    check_rmw<bus_t, typename Traits::unwritten_fields_per_reg_t,
+              typename Traits::field_masks_t>();
+    check_read_effects<Traits>();
+    check_loads<Policy, Traits>();
+}
+} // namespace detail
+
+template <detail::write_policy Policy = max_loads<>,
+          detail::write_spec_like Spec>
+auto write(Spec const &s) -> async::sender auto {
+    using traits = detail::write_traits<Spec>;
+    using bus_t = typename traits::bus_t;
+    detail::check_write<Policy, traits>();
+    return detail::write_runs<bus_t, typename traits::writes_t, traits::plan>(
+        s);
+}
+
+// The accesses that write(spec) will make on the bus, computed at compile
+// time.
+template <detail::write_spec_like Spec> consteval auto plan_of() {
+    return detail::write_traits<std::remove_cvref_t<Spec>>::accesses();
+}
+
+template <detail::write_spec_like Spec>
+consteval auto plan_of(Spec const &) {
+    return plan_of<Spec>();
+}
+
+template <detail::write_policy Policy = max_loads<>,
+          detail::write_spec_like Spec, typename... Args>
     requires(sizeof...(Args) > 0)
 auto write(Spec const &s, Args &&...args) -> async::sender auto {
-    return write(s) |
+    return write<Policy>(s) |
            async::let_value([... as = std::forward<Args>(args)](auto &&...rs) {
                return async::just(FWD(rs)..., std::move(as)...);
            });
 }
 
 namespace _write {
-template <typename... Ts> struct pipeable {
+template <typename Policy, typename... Ts> struct pipeable {
     stdx::tuple<std::decay_t<Ts>...> passthrough_values{};
 
   private:
@@ -181,18 +464,19 @@ template <typename... Ts> struct pipeable {
                    [values = std::forward<P>(p).passthrough_values]<
                        detail::write_spec_like Spec>(Spec &&spec) {
                        return std::move(values).apply([&](auto &&...vs) {
-                           return write(std::forward<Spec>(spec), FWD(vs)...);
+                           return write<Policy>(std::forward<Spec>(spec),
+                                                FWD(vs)...);
                        });
                    });
     }
 };
 } // namespace _write
 
-template <typename... Args>
+template <detail::write_policy Policy = max_loads<>, typename... Args>
     requires(... and (not detail::write_spec_like<Args>))
 constexpr auto write(Args &&...args) {
     return async::compose(
-        _write::pipeable<Args...>{std::forward<Args>(args)...});
+        _write::pipeable<Policy, Args...>{std::forward<Args>(args)...});
 }
 
 namespace _sync_write {
@@ -211,7 +495,7 @@ template <typename Behavior, async::sender S> auto wait(S &&s) {
     }
 }
 
-template <typename Behavior, typename... Ts> struct pipeable {
+template <typename Behavior, typename Policy, typename... Ts> struct pipeable {
     stdx::tuple<std::decay_t<Ts>...> passthrough_values{};
 
   private:
@@ -220,19 +504,23 @@ template <typename Behavior, typename... Ts> struct pipeable {
         return wait<Behavior>(
             std::forward<S>(s) |
             std::forward<P>(p).passthrough_values.apply(
-                [](auto &&...args) { return write(FWD(args)...); }));
+                [](auto &&...args) { return write<Policy>(FWD(args)...); }));
     }
 };
 } // namespace _sync_write
 
-template <typename Behavior = non_blocking, typename... Ts>
+template <detail::sync_behavior Behavior = non_blocking,
+          detail::write_policy Policy = max_loads<>, typename... Ts>
 auto sync_write(Ts &&...ts) {
-    return _sync_write::wait<Behavior>(write(std::forward<Ts>(ts)...));
+    return _sync_write::wait<Behavior>(
+        write<Policy>(std::forward<Ts>(ts)...));
 }
 
-template <typename Behavior = non_blocking, typename... Args>
+template <detail::sync_behavior Behavior = non_blocking,
+          detail::write_policy Policy = max_loads<>, typename... Args>
     requires(... and (not detail::write_spec_like<Args>))
-auto sync_write(Args &&...args) -> _sync_write::pipeable<Behavior, Args...> {
+auto sync_write(Args &&...args)
+    -> _sync_write::pipeable<Behavior, Policy, Args...> {
     return {std::forward<Args>(args)...};
 }
 } // namespace groov
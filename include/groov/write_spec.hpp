@@ -13,6 +13,8 @@
 #include <boost/mp11/algorithm.hpp>
 #include <boost/mp11/list.hpp>
 
+#include <cstddef>
+
 namespace groov {
 namespace detail {
 struct no_extract_type {};
@@ -171,7 +173,7 @@ template <typename R, typename F> struct field_proxy {
 } // namespace detail
 
 template <typename Group, typename Paths, typename Value>
-struct write_spec : Group {
+struct write_spec : Group, detail::spec_index_for<Group, Paths> {
     using is_write_spec = void;
     using paths_t = Paths;
     using value_t = Value;
@@ -244,7 +246,8 @@ struct write_spec : Group {
 };
 
 template <typename Group, typename Paths, valued_pathlike... Ps>
-constexpr auto to_write_spec(read_spec<Group, Paths>, Ps const &...ps) {
+constexpr auto to_write_spec(read_spec<Group, Paths> const &s,
+                             Ps const &...ps) {
     using paths_by_register =
         boost::mpx::mp_gather_q<detail::register_for_path_q<Group>, Paths>;
     using registers =
@@ -257,6 +260,7 @@ constexpr auto to_write_spec(read_spec<Group, Paths>, Ps const &...ps) {
 
     return [&]() -> write_spec<Group, Paths, register_data_t> {
         auto w = write_spec<Group, Paths, register_data_t>{};
+        detail::set_index(w, s.index);
         [[maybe_unused]] constexpr auto insert =
             []<valued_pathlike P>(P const &p, [[maybe_unused]] auto &values) {
                 using matches =
@@ -0,0 +1,163 @@
+#include <groov/alias.hpp>
+#include <groov/config.hpp>
+#include <groov/identity.hpp>
+#include <groov/mmio_bus.hpp>
+#include <groov/path.hpp>
+#include <groov/shadow.hpp>
+#include <groov/value_path.hpp>
+#include <groov/write.hpp>
+#include <groov/write_spec.hpp>
+
+#include <async/concepts.hpp>
+#include <async/sync_wait.hpp>
+
+#include <stdx/bit.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace groov::literals;
+
+namespace {
+// a register at 0x0, with a set alias at 0x4 and a clear alias at 0x8; and
+// another register at 0xc with aliases at 0x10 and 0x14
+std::array<std::uint32_t, 6> regs{};
+
+struct iface {
+    static inline std::size_t num_stores{};
+    static inline std::size_t num_loads{};
+    static inline std::vector<std::uintptr_t> store_addrs{};
+
+    static auto to_mem(std::uintptr_t addr) -> std::uintptr_t {
+        return stdx::bit_cast<std::uintptr_t>(regs.data()) + addr;
+    }
+
+    template <std::unsigned_integral T> static auto store(std::uintptr_t addr) {
+        return async::then([=](T value) -> void {
+            ++num_stores;
+            store_addrs.push_back(addr);
+            switch (addr) {
+            case 0x4u:
+                regs[0] |= value;
+                break;
+            case 0x8u:
+                regs[0] &= ~value;
+                break;
+            default:
+                regs[addr / sizeof(std::uint32_t)] = value;
+                break;
+            }
+        });
+    }
+
+    template <std::unsigned_integral T>
+    static auto load(std::uintptr_t addr) -> async::sender auto {
+        ++num_loads;
+        return groov::cpp_mem_iface::template load<T>(to_mem(addr));
+    }
+
+    template <typename T>
+    constexpr static std::size_t alignment =
+        groov::cpp_mem_iface::template alignment<T>;
+};
+
+using F_en = groov::field<"en", std::uint8_t, 0, 0>;
+using F_mode = groov::field<"mode", std::uint8_t, 7, 4>;
+
+using R = groov::reg<"reg", std::uint32_t, 0x0u, groov::w::replace,
+                     groov::attr::set_clear_aliases<0x4u, 0x8u>, F_en,
+                     F_mode>;
+
+using R_whole = groov::reg<"whole", std::uint32_t, 0xcu, groov::w::replace,
+                           groov::attr::set_clear_aliases<0x4u, 0x8u>>;
+
+using G = groov::group<"group", groov::mmio_bus<iface>, R, R_whole>;
+constexpr auto grp = G{};
+
+auto reset(std::uint32_t value) {
+    regs = {value, 0u, 0u, 0u, 0u, 0u};
+    iface::num_stores = {};
+    iface::num_loads = {};
+    iface::store_addrs.clear();
+}
+} // namespace
+
+TEST_CASE("setting a single bit uses the set alias", "[alias]") {
+    reset(0xa0u);
+    CHECK(sync_write(grp("reg.en"_f = 1u)));
+    CHECK(iface::num_loads == 0);
+    CHECK(iface::num_stores == 1);
+    CHECK(regs[0] == 0xa1u);
+}
+
+TEST_CASE("clearing a single bit uses the clear alias", "[alias]") {
+    reset(0xa1u);
+    CHECK(sync_write(grp("reg.en"_f = groov::clear)));
+    CHECK(iface::num_loads == 0);
+    CHECK(iface::num_stores == 1);
+    CHECK(regs[0] == 0xa0u);
+}
+
+TEST_CASE("writing a multi-bit field is a read-modify-write", "[alias]") {
+    reset(0x31u);
+    CHECK(sync_write(grp("reg.mode"_f = 0xau)));
+    CHECK(iface::num_loads == 1);
+    CHECK(iface::store_addrs == std::vector<std::uintptr_t>{0x0u});
+    CHECK(regs[0] == 0xa1u);
+}
+
+namespace {
+using R_split =
+    groov::reg<"reg", std::uint32_t, 0x0u, groov::w::replace,
+               groov::attr::set_clear_aliases<
+                   0x4u, 0x8u, groov::attr::multi_bit_writes::split>,
+               F_en, F_mode>;
+using G_split = groov::group<"group", groov::mmio_bus<iface>, R_split>;
+constexpr auto grp_split = G_split{};
+} // namespace
+
+TEST_CASE("a split multi-bit write uses both aliases", "[alias]") {
+    reset(0x31u);
+    CHECK(sync_write(grp_split("reg.mode"_f = 0xau)));
+    CHECK(iface::num_loads == 0);
+    CHECK(iface::num_stores == 2);
+    CHECK(regs[0] == 0xa1u);
+}
+
+TEST_CASE("a split multi-bit write clears bits before it sets them",
+          "[alias]") {
+    reset(0x31u);
+    CHECK(sync_write(grp_split("reg.mode"_f = 0xau)));
+    CHECK(iface::store_addrs == std::vector<std::uintptr_t>{0x8u, 0x4u});
+}
+
+TEST_CASE("writing a whole register uses the register", "[alias]") {
+    reset(0x31u);
+    CHECK(sync_write(grp("whole"_r = 0x1234'5678u)));
+    CHECK(iface::num_loads == 0);
+    CHECK(iface::num_stores == 1);
+    CHECK(regs[0] == 0x31u);
+    CHECK(regs[3] == 0x1234'5678u);
+}
+
+namespace {
+using R_shadowed =
+    groov::reg<"reg", std::uint32_t, 0x0u, groov::w::replace,
+               groov::attr::set_clear_aliases<0x4u, 0x8u>,
+               groov::attr::shadowed, F_en, F_mode>;
+using G_shadowed = groov::group<"group", groov::mmio_bus<iface>, R_shadowed>;
+constexpr auto grp_shadowed = G_shadowed{};
+} // namespace
+
+TEST_CASE("aliased writes keep the shadow up to date", "[alias]") {
+    reset(0x30u);
+    CHECK(groov::resync(grp_shadowed("reg"_r)) | async::sync_wait());
+    CHECK(sync_write(grp_shadowed("reg.en"_f = 1u)));
+    CHECK(groov::detail::shadow_t<G_shadowed::bus_t, R_shadowed>::value ==
+          0x31u);
+}
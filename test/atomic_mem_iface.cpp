@@ -0,0 +1,188 @@
+#include <groov/atomic_mem_iface.hpp>
+#include <groov/config.hpp>
+#include <groov/mmio_bus.hpp>
+#include <groov/path.hpp>
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/value_path.hpp>
+#include <groov/write.hpp>
+#include <groov/write_spec.hpp>
+
+#include <async/just.hpp>
+#include <async/just_result_of.hpp>
+#include <async/sync_wait.hpp>
+#include <async/then.hpp>
+
+#include <stdx/bit.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+alignas(std::uint32_t) std::uint32_t data{};
+
+// none of these fields can be written with a subword store
+using F0 = groov::field<"field0", std::uint8_t, 4, 0>;
+using F1 = groov::field<"field1", std::uint8_t, 12, 5>;
+using F2 = groov::field<"field2", std::uint8_t, 19, 13>;
+using F3 = groov::field<"field3", std::uint16_t, 31, 20>;
+
+using R = groov::reg<"reg", std::uint32_t, &data, groov::w::replace, F0, F1,
+                     F2, F3>;
+using G =
+    groov::group<"group", groov::mmio_bus<groov::atomic_mem_iface>, R>;
+constexpr auto grp = G{};
+
+using bus = groov::mmio_bus<groov::atomic_mem_iface>;
+
+// the same register layout, in plain memory behind a mutex: each access, and
+// each read-modify-write as a whole, holds the lock
+alignas(std::uint32_t) std::uint32_t locked_data{};
+
+struct mutex_mem_iface {
+    static inline std::mutex mutex{};
+
+    template <std::unsigned_integral T>
+    static auto store(std::uintptr_t iaddr) {
+        return async::then([=](T value) -> void {
+            std::lock_guard lock{mutex};
+            *stdx::bit_cast<T volatile *>(iaddr) = value;
+        });
+    }
+
+    template <std::unsigned_integral T>
+    static auto load(std::uintptr_t iaddr) -> async::sender auto {
+        return async::just_result_of([=]() -> T {
+            std::lock_guard lock{mutex};
+            return *stdx::bit_cast<T volatile *>(iaddr);
+        });
+    }
+
+    template <std::unsigned_integral T>
+    static auto modify(std::uintptr_t iaddr, T keep) {
+        return async::then([=](T bits) -> void {
+            std::lock_guard lock{mutex};
+            auto *p = stdx::bit_cast<T volatile *>(iaddr);
+            *p = static_cast<T>((*p & keep) | bits);
+        });
+    }
+
+    template <typename T> constexpr static std::size_t alignment = alignof(T);
+};
+
+using R_locked = groov::reg<"reg", std::uint32_t, &locked_data,
+                            groov::w::replace, F0, F1, F2, F3>;
+using G_locked =
+    groov::group<"group", groov::mmio_bus<mutex_mem_iface>, R_locked>;
+constexpr auto grp_locked = G_locked{};
+
+// each of four threads writes its own field of the register
+template <typename Group> auto write_fields_concurrently(Group grp) -> void {
+    using namespace groov::literals;
+    constexpr auto iterations = 1'000;
+    auto writer = [&](auto field) {
+        return std::thread{[=] {
+            for (auto i = 0; i < iterations; ++i) {
+                std::ignore = sync_write(grp(field = (i + 1) % 32));
+            }
+        }};
+    };
+    std::vector<std::thread> threads{};
+    threads.push_back(writer("reg.field0"_f));
+    threads.push_back(writer("reg.field1"_f));
+    threads.push_back(writer("reg.field2"_f));
+    threads.push_back(writer("reg.field3"_f));
+    for (auto &t : threads) {
+        t.join();
+    }
+}
+} // namespace
+
+TEST_CASE("atomic store and load", "[atomic_mem_iface]") {
+    using namespace groov::literals;
+    data = 0;
+    CHECK(sync_write(grp("reg"_r = 0xdead'beefu)));
+    CHECK(data == 0xdead'beefu);
+    CHECK(sync_read(grp("reg"_r))["reg"_r] == 0xdead'beefu);
+}
+
+TEST_CASE("atomic RMW that only sets bits", "[atomic_mem_iface]") {
+    data = 0x8765'4321u;
+    CHECK(bus::write<"", 0x00f0'0000u, 0u, 0u>(&data, 0x00f0'0000u) |
+          async::sync_wait());
+    CHECK(data == 0x87f5'4321u);
+}
+
+TEST_CASE("atomic RMW that only clears bits", "[atomic_mem_iface]") {
+    data = 0x8765'4321u;
+    CHECK(bus::write<"", 0x00f0'0000u, 0u, 0u>(&data, 0u) |
+          async::sync_wait());
+    CHECK(data == 0x8705'4321u);
+}
+
+TEST_CASE("atomic RMW that sets and clears bits", "[atomic_mem_iface]") {
+    data = 0x8765'4321u;
+    CHECK(bus::write<"", 0x00f0'0000u, 0x0f00'0000u, 0x0a00'0000u>(
+              &data, 0x00c0'0000u) |
+          async::sync_wait());
+    CHECK(data == 0x8ac5'4321u);
+}
+
+TEST_CASE("concurrent writes to different fields are not lost",
+          "[atomic_mem_iface]") {
+    using namespace groov::literals;
+    data = 0;
+    constexpr auto iterations = 10'000;
+
+    auto writer = [&](auto field) {
+        return std::thread{[=] {
+            for (auto i = 0; i < iterations; ++i) {
+                std::ignore = sync_write(grp(field = (i + 1) % 256));
+            }
+        }};
+    };
+
+    std::vector<std::thread> threads{};
+    threads.push_back(writer("reg.field0"_f));
+    threads.push_back(writer("reg.field1"_f));
+    threads.push_back(writer("reg.field2"_f));
+    threads.push_back(writer("reg.field3"_f));
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    auto const r = sync_read(grp("reg"_r));
+    CHECK(r["reg.field0"_f] == iterations % 32);
+    CHECK(r["reg.field1"_f] == iterations % 256);
+    CHECK(r["reg.field2"_f] == iterations % 128);
+    CHECK(r["reg.field3"_f] == iterations % 256);
+}
+
+TEST_CASE("atomic read-modify-write", "[.][benchmark]") {
+    using namespace groov::literals;
+    data = 0;
+    locked_data = 0;
+    auto i = 0u;
+    BENCHMARK("atomic modify") {
+        return sync_write(grp("reg.field1"_f = static_cast<std::uint8_t>(++i)));
+    };
+    BENCHMARK("modify under a mutex") {
+        return sync_write(
+            grp_locked("reg.field1"_f = static_cast<std::uint8_t>(++i)));
+    };
+}
+
+TEST_CASE("contended read-modify-write", "[.][benchmark]") {
+    BENCHMARK("atomic modify") { write_fields_concurrently(grp); };
+    BENCHMARK("modify under a mutex") {
+        write_fields_concurrently(grp_locked);
+    };
+}
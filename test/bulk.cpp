@@ -0,0 +1,82 @@
+#include <groov/bulk.hpp>
+#include <groov/config.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace {
+enum struct mode : std::uint8_t { off, slow, fast };
+
+using F_en = groov::field<"en", bool, 0, 0>;
+using F_mode = groov::field<"mode", mode, 2, 1>;
+using F_count = groov::field<"count", std::uint16_t, 23, 8>;
+using R = groov::reg<"reg", std::uint32_t, 0u, groov::w::replace, F_en,
+                     F_mode, F_count>;
+} // namespace
+
+TEST_CASE("extract a field from an array of register values", "[bulk]") {
+    constexpr auto regs = std::array<std::uint32_t, 4>{
+        0x0000'0001u, 0x0012'3402u, 0x00ff'ff05u, 0xff00'0004u};
+
+    auto counts = std::array<std::uint16_t, 4>{};
+    groov::extract_all<F_count>(std::span{regs}, std::span{counts});
+    CHECK(counts == std::array<std::uint16_t, 4>{0, 0x1234, 0xffff, 0});
+
+    auto modes = std::array<mode, 4>{};
+    groov::extract_all<F_mode>(std::span{regs}, std::span{modes});
+    CHECK(modes ==
+          std::array{mode::off, mode::slow, mode::fast, mode::fast});
+
+    auto enables = std::array<bool, 4>{};
+    groov::extract_all<F_en>(std::span{regs}, std::span{enables});
+    CHECK(enables == std::array{true, false, true, false});
+}
+
+TEST_CASE("extract a whole register", "[bulk]") {
+    auto const regs = std::vector<std::uint32_t>{1, 2, 3};
+    auto out = std::vector<std::uint32_t>(3);
+    groov::extract_all<R>(std::span{regs}, std::span{out});
+    CHECK(out == regs);
+}
+
+TEST_CASE("extract converts only as many values as fit", "[bulk]") {
+    constexpr auto regs =
+        std::array<std::uint32_t, 3>{0x100u, 0x200u, 0x300u};
+    auto counts = std::array<std::uint16_t, 2>{};
+    CHECK(groov::extract_all<F_count>(std::span{regs}, std::span{counts}) ==
+          2);
+    CHECK(counts == std::array<std::uint16_t, 2>{1, 2});
+}
+
+TEST_CASE("insert converts only as many values as there are", "[bulk]") {
+    auto regs = std::vector<std::uint32_t>{0u, 0u, 0u};
+    auto const counts = std::vector<std::uint16_t>{1, 2};
+    CHECK(groov::insert_all<F_count>(std::span{regs}, std::span{counts}) ==
+          2);
+    CHECK(regs == std::vector<std::uint32_t>{0x100u, 0x200u, 0u});
+}
+
+TEST_CASE("insert a field into an array of register values", "[bulk]") {
+    auto regs = std::array<std::uint32_t, 3>{0xff00'0001u, 0xff00'0000u,
+                                             0xffff'ff07u};
+    constexpr auto counts = std::array<std::uint16_t, 3>{1, 0xabcd, 0};
+    groov::insert_all<F_count>(std::span{regs}, std::span{counts});
+    CHECK(regs == std::array<std::uint32_t, 3>{0xff00'0101u, 0xffab'cd00u,
+                                               0xff00'0007u});
+}
+
+TEST_CASE("bulk extract and insert are constexpr", "[bulk]") {
+    constexpr auto mode_of = [] {
+        auto regs = std::array<std::uint32_t, 2>{};
+        constexpr auto modes = std::array{mode::fast, mode::slow};
+        groov::insert_all<F_mode>(std::span{regs}, std::span{modes});
+        auto out = std::array<mode, 2>{};
+        groov::extract_all<F_mode>(std::span{regs}, std::span{out});
+        return out;
+    }();
+    STATIC_CHECK(mode_of == std::array{mode::fast, mode::slow});
+}
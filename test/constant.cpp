@@ -0,0 +1,135 @@
+#include <groov/config.hpp>
+#include <groov/constant.hpp>
+#include <groov/path.hpp>
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/test.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just_result_of.hpp>
+#include <async/sync_wait.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+using namespace groov::literals;
+
+namespace {
+std::uint32_t id{0x1234'0001u};
+std::uint32_t version{0x0002'0003u};
+std::uint32_t status{};
+std::size_t num_reads{};
+
+struct bus {
+    template <stdx::ct_string, auto>
+    static auto read(std::uint32_t *addr) -> async::sender auto {
+        return async::just_result_of([=] {
+            ++num_reads;
+            return *addr;
+        });
+    }
+
+    template <stdx::ct_string, auto Mask, auto, auto>
+    static auto write(std::uint32_t *addr, std::uint32_t value)
+        -> async::sender auto {
+        return async::just_result_of(
+            [=] { *addr = (*addr & ~Mask) | (value & Mask); });
+    }
+};
+
+using F_vendor = groov::field<"vendor", std::uint16_t, 31, 16>;
+using F_rev = groov::field<"rev", std::uint16_t, 15, 0>;
+using R_id = groov::reg<"id", std::uint32_t, &id, groov::w::replace,
+                        groov::attr::constant, F_vendor, F_rev>;
+using R_version = groov::reg<"version", std::uint32_t, &version,
+                             groov::w::replace, groov::attr::constant>;
+using R_status = groov::reg<"status", std::uint32_t, &status>;
+
+using G = groov::group<"group", bus, R_id, R_version, R_status>;
+constexpr auto grp = G{};
+
+auto reset() {
+    groov::reset_cache(grp);
+    num_reads = {};
+}
+} // namespace
+
+TEST_CASE("a constant register is read from the bus once", "[constant]") {
+    reset();
+    CHECK(groov::sync_read(grp / "id"_r) == 0x1234'0001u);
+    CHECK(num_reads == 1);
+    CHECK(groov::sync_read(grp / "id"_r) == 0x1234'0001u);
+    CHECK(num_reads == 1);
+}
+
+TEST_CASE("the cache answers reads of any field", "[constant]") {
+    reset();
+    CHECK(groov::sync_read(grp / "id.rev"_f) == 1u);
+    CHECK(groov::sync_read(grp / "id.vendor"_f) == 0x1234u);
+    CHECK(num_reads == 1);
+}
+
+TEST_CASE("non-constant registers are still read", "[constant]") {
+    reset();
+    auto r = groov::sync_read(grp("id"_r, "status"_r));
+    CHECK(r["id"_r] == 0x1234'0001u);
+    CHECK(num_reads == 2);
+    r = groov::sync_read(grp("id"_r, "status"_r));
+    CHECK(num_reads == 3);
+}
+
+TEST_CASE("prime reads every constant register in a group", "[constant]") {
+    reset();
+    CHECK(groov::prime(grp) | async::sync_wait());
+    CHECK(num_reads == 2);
+    CHECK(groov::sync_read(grp / "version"_r) == 0x0002'0003u);
+    CHECK(groov::sync_read(grp / "id"_r) == 0x1234'0001u);
+    CHECK(num_reads == 2);
+}
+
+TEST_CASE("reset_cache makes the next read go to the bus", "[constant]") {
+    reset();
+    CHECK(groov::prime(grp) | async::sync_wait());
+    version = 0x0002'0004u;
+    CHECK(groov::sync_read(grp / "version"_r) == 0x0002'0003u);
+    groov::reset_cache(grp);
+    CHECK(groov::sync_read(grp / "version"_r) == 0x0002'0004u);
+    CHECK(num_reads == 3);
+    version = 0x0002'0003u;
+}
+
+TEST_CASE("the cache is consulted when a read starts", "[constant]") {
+    reset();
+    CHECK(groov::prime(grp) | async::sync_wait());
+    auto const s = groov::read(grp / "version"_r);
+    version = 0x0002'0004u;
+    groov::reset_cache(grp);
+    auto r = s | async::sync_wait();
+    REQUIRE(r);
+    CHECK(get<0>(*r)["version"_r] == 0x0002'0004u);
+    CHECK(num_reads == 3);
+    version = 0x0002'0003u;
+}
+
+namespace {
+using R_test_id = groov::reg<"id", std::uint32_t, 0x0u, groov::w::replace,
+                             groov::attr::constant>;
+using TG = groov::group<"test", groov::test::bus<"test">, R_test_id>;
+constexpr auto tgrp = TG{};
+} // namespace
+
+TEST_CASE("a failed read is not cached", "[constant]") {
+    groov::test::reset_store<TG>();
+    groov::reset_cache(tgrp);
+    auto r = groov::read(tgrp / "id"_r) | async::sync_wait();
+    REQUIRE(r);
+    CHECK(not get<0>(*r));
+    groov::test::set_value<TG>("id"_r, 0x42u);
+    r = groov::read(tgrp / "id"_r) | async::sync_wait();
+    REQUIRE(r);
+    REQUIRE(get<0>(*r));
+    CHECK((*get<0>(*r))["id"_r] == 0x42u);
+}
@@ -0,0 +1,26 @@
+#include "dummy_bus.hpp"
+
+#include <groov/config.hpp>
+#include <groov/path.hpp>
+#include <groov/read_spec.hpp>
+
+#include <cstdint>
+
+// EXPECT: Path \(arr.field0\) to a register array in group \(group\)
+
+namespace {
+using F0 = groov::field<"field0", std::uint8_t, 0, 0>;
+using F1 = groov::field<"field1", std::uint8_t, 1, 1>;
+
+std::uint32_t data{};
+using R = groov::reg<"reg", std::uint32_t, &data, groov::w::replace, F0, F1>;
+using A = groov::reg_array<"arr", 4, 4, R>;
+
+using G = groov::group<"group", dummy_bus, A>;
+} // namespace
+
+auto main() -> int {
+    using namespace groov::literals;
+    constexpr auto grp = G{};
+    [[maybe_unused]] auto x = grp("arr.field0"_f);
+}
@@ -0,0 +1,37 @@
+#include "../dummy_bus.hpp"
+
+#include <groov/config.hpp>
+#include <groov/constant.hpp>
+#include <groov/identity.hpp>
+#include <groov/path.hpp>
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+
+#include <cstdint>
+
+// read a constant register that also clears on read
+
+// EXPECT: Register reg is constant, but has side effects on read
+
+namespace {
+struct read_bus : dummy_bus {
+    template <stdx::ct_string, auto>
+    static auto read(auto...) -> async::sender auto {
+        return async::just(42u);
+    }
+};
+
+std::uint32_t data{};
+using R = groov::reg<"reg", std::uint32_t, &data,
+                     groov::r::clear_on_read<groov::w::ignore>,
+                     groov::attr::constant>;
+using G = groov::group<"group", read_bus, R>;
+} // namespace
+
+auto main() -> int {
+    using namespace groov::literals;
+    [[maybe_unused]] auto s = groov::read(G{} / "reg"_r);
+}
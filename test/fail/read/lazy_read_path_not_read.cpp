@@ -0,0 +1,37 @@
+#include "../dummy_bus.hpp"
+
+#include <groov/config.hpp>
+#include <groov/lazy_read.hpp>
+#include <groov/path.hpp>
+#include <groov/read_spec.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+
+#include <cstdint>
+
+// access a field of a lazily-read register that the read did not cover
+
+// EXPECT: Path reg.f1 is not part of the lazy read
+
+namespace {
+struct read_bus : dummy_bus {
+    template <stdx::ct_string, auto>
+    static auto read(auto...) -> async::sender auto {
+        return async::just(42u);
+    }
+};
+
+using F0 = groov::field<"f0", std::uint8_t, 0, 0>;
+using F1 = groov::field<"f1", std::uint8_t, 1, 1>;
+
+std::uint32_t data{};
+using R = groov::reg<"reg", std::uint32_t, &data, groov::w::replace, F0, F1>;
+using G = groov::group<"group", read_bus, R>;
+} // namespace
+
+auto main() -> int {
+    using namespace groov::literals;
+    auto l = groov::lazy_read(G{} / "reg.f0"_f);
+    [[maybe_unused]] auto x = l["reg.f1"_f];
+}
@@ -0,0 +1,43 @@
+#include "../dummy_bus.hpp"
+
+#include <groov/config.hpp>
+#include <groov/path.hpp>
+#include <groov/read.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+
+#include <cstdint>
+
+// read three paths into a struct with two members
+
+// EXPECT: it must have exactly one member for each path, in order
+
+namespace {
+struct read_bus : dummy_bus {
+    template <stdx::ct_string, auto>
+    static auto read(auto...) -> async::sender auto {
+        return async::just(42u);
+    }
+};
+
+using F0 = groov::field<"f0", std::uint8_t, 0, 0>;
+using F1 = groov::field<"f1", std::uint8_t, 1, 1>;
+using F2 = groov::field<"f2", std::uint8_t, 2, 2>;
+
+std::uint32_t data{};
+using R =
+    groov::reg<"reg", std::uint32_t, &data, groov::w::replace, F0, F1, F2>;
+using G = groov::group<"group", read_bus, R>;
+
+struct two {
+    std::uint8_t a;
+    std::uint8_t b;
+};
+} // namespace
+
+auto main() -> int {
+    using namespace groov::literals;
+    [[maybe_unused]] auto x =
+        groov::read_as<two>(G{}("reg.f0"_f, "reg.f1"_f, "reg.f2"_f));
+}
@@ -0,0 +1,32 @@
+#include "../dummy_bus.hpp"
+
+#include <groov/config.hpp>
+#include <groov/path.hpp>
+#include <groov/tear_free.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+
+#include <cstdint>
+
+// read a register pair from a register that does not declare its high word
+
+// EXPECT: Register reg has no attr::high_word
+
+namespace {
+struct read_bus : dummy_bus {
+    template <stdx::ct_string, auto>
+    static auto read(auto...) -> async::sender auto {
+        return async::just(42u);
+    }
+};
+
+std::uint32_t data{};
+using R = groov::reg<"reg", std::uint32_t, &data>;
+using G = groov::group<"group", read_bus, R>;
+} // namespace
+
+auto main() -> int {
+    using namespace groov::literals;
+    [[maybe_unused]] auto s = groov::read_tear_free(G{} / "reg"_r);
+}
@@ -0,0 +1,21 @@
+#include "../dummy_bus.hpp"
+
+#include <groov/config.hpp>
+#include <groov/path.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/shadow.hpp>
+
+#include <cstdint>
+
+// EXPECT: Attempting to resync or invalidate a register that is not shadowed
+
+namespace {
+std::uint32_t data{};
+using R = groov::reg<"reg", std::uint32_t, &data>;
+using G = groov::group<"group", dummy_bus, R>;
+} // namespace
+
+auto main() -> int {
+    using namespace groov::literals;
+    [[maybe_unused]] auto s = groov::resync(G{}("reg"_r));
+}
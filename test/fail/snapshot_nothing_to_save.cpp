@@ -0,0 +1,19 @@
+#include "dummy_bus.hpp"
+
+#include <groov/config.hpp>
+#include <groov/identity.hpp>
+#include <groov/snapshot.hpp>
+
+#include <cstdint>
+
+// EXPECT: Group group has no registers that can be saved
+
+namespace {
+std::uint32_t data{};
+using R = groov::reg<"reg", std::uint32_t, &data,
+                     groov::read_only<groov::w::ignore>>;
+
+using G = groov::group<"group", dummy_bus, R>;
+} // namespace
+
+auto main() -> int { [[maybe_unused]] auto s = groov::snapshot(G{}); }
@@ -0,0 +1,31 @@
+#include "../dummy_bus.hpp"
+
+#include <groov/config.hpp>
+#include <groov/path.hpp>
+#include <groov/value_path.hpp>
+#include <groov/write.hpp>
+#include <groov/write_spec.hpp>
+
+#include <cstdint>
+
+// writing fields of two registers, each needing a read-modify-write, with a
+// budget of one load
+
+// EXPECT: Write would exceed its budget of bus loads
+
+namespace {
+using F0 = groov::field<"field0", std::uint8_t, 0, 0>;
+using F1 = groov::field<"field1", std::uint32_t, 31, 1>;
+
+std::uint32_t data0{};
+using R0 = groov::reg<"reg0", std::uint32_t, &data0, groov::w::replace, F0, F1>;
+std::uint32_t data1{};
+using R1 = groov::reg<"reg1", std::uint32_t, &data1, groov::w::replace, F0, F1>;
+using G = groov::group<"group", dummy_bus, R0, R1>;
+} // namespace
+
+auto main() -> int {
+    using namespace groov::literals;
+    [[maybe_unused]] auto x = groov::write<groov::max_loads<1>>(
+        G{}("reg0.field0"_f = 1, "reg1.field0"_f = 1));
+}
@@ -0,0 +1,30 @@
+#include "../dummy_bus.hpp"
+
+#include <groov/config.hpp>
+#include <groov/identity.hpp>
+#include <groov/modify.hpp>
+#include <groov/path.hpp>
+#include <groov/read_spec.hpp>
+
+#include <cstdint>
+
+// modifying a field of a register whose other field pops on read
+
+// EXPECT: modify\(\) would read register reg, but data has side effects
+
+namespace {
+using F0 = groov::field<"field0", std::uint8_t, 0, 0>;
+using F_data =
+    groov::field<"data", std::uint8_t, 15, 8, groov::r::pop<groov::w::ignore>>;
+
+std::uint32_t data{};
+using R =
+    groov::reg<"reg", std::uint32_t, &data, groov::w::ignore, F0, F_data>;
+using G = groov::group<"group", dummy_bus, R>;
+} // namespace
+
+auto main() -> int {
+    using namespace groov::literals;
+    [[maybe_unused]] auto x = groov::modify(
+        G{}("reg.field0"_f), [](auto &spec) { spec["reg.field0"_f] = 1; });
+}
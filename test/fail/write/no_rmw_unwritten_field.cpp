@@ -0,0 +1,29 @@
+#include "../dummy_bus.hpp"
+
+#include <groov/config.hpp>
+#include <groov/path.hpp>
+#include <groov/value_path.hpp>
+#include <groov/write.hpp>
+#include <groov/write_spec.hpp>
+
+#include <cstdint>
+
+// writing one field under a no-RMW policy, when another field in the same
+// register must be preserved with a read-modify-write
+
+// EXPECT: Write to register reg would incur a load to preserve field field1
+
+namespace {
+using F0 = groov::field<"field0", std::uint8_t, 0, 0>;
+using F1 = groov::field<"field1", std::uint32_t, 31, 1>;
+
+std::uint32_t data{};
+using R = groov::reg<"reg", std::uint32_t, &data, groov::w::replace, F0, F1>;
+using G = groov::group<"group", dummy_bus, R>;
+} // namespace
+
+auto main() -> int {
+    using namespace groov::literals;
+    [[maybe_unused]] auto x =
+        groov::write<groov::no_rmw>(G{}("reg.field0"_f = 1));
+}
@@ -0,0 +1,31 @@
+#include "../dummy_bus.hpp"
+
+#include <groov/config.hpp>
+#include <groov/identity.hpp>
+#include <groov/path.hpp>
+#include <groov/value_path.hpp>
+#include <groov/write.hpp>
+#include <groov/write_spec.hpp>
+
+#include <cstdint>
+
+// writing one field when the read-modify-write needed to preserve the rest of
+// the register would load a field that clears on read
+
+// EXPECT: Write to register reg would load status
+
+namespace {
+using F0 = groov::field<"field0", std::uint8_t, 0, 0>;
+using F_status = groov::field<"status", std::uint32_t, 31, 1,
+                              groov::r::clear_on_read<groov::w::replace>>;
+
+std::uint32_t data{};
+using R =
+    groov::reg<"reg", std::uint32_t, &data, groov::w::replace, F0, F_status>;
+using G = groov::group<"group", dummy_bus, R>;
+} // namespace
+
+auto main() -> int {
+    using namespace groov::literals;
+    [[maybe_unused]] auto x = groov::write(G{}("reg.field0"_f = 1));
+}
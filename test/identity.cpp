@@ -54,3 +54,23 @@ TEST_CASE("write zero to set/clear write function has one identity",
     STATIC_CHECK(
         std::is_same_v<groov::w::zero_to_clear::id_spec, groov::m::one>);
 }
+
+TEST_CASE("read behaviours mark a write function with a read effect",
+          "[identity]") {
+    using C = groov::r::clear_on_read<groov::w::one_to_clear>;
+    using P = groov::r::pop<groov::w::replace>;
+    STATIC_CHECK(groov::read_effect_write_function<C>);
+    STATIC_CHECK(groov::read_effect_write_function<P>);
+    STATIC_CHECK(not groov::read_effect_write_function<groov::w::replace>);
+    STATIC_CHECK(std::is_same_v<C::id_spec, groov::m::zero>);
+}
+
+TEST_CASE("read behaviours compose with read-only and write-only",
+          "[identity]") {
+    using RO = groov::read_only<groov::r::clear_on_read<groov::w::ignore>>;
+    using WO = groov::write_only<groov::r::pop<groov::w::replace>>;
+    STATIC_CHECK(groov::read_effect_write_function<RO>);
+    STATIC_CHECK(groov::read_only_write_function<RO>);
+    STATIC_CHECK(groov::read_effect_write_function<WO>);
+    STATIC_CHECK(groov::write_only_write_function<WO>);
+}
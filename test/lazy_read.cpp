@@ -0,0 +1,139 @@
+#include <groov/config.hpp>
+#include <groov/lazy_read.hpp>
+#include <groov/path.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/test.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+#include <async/just_result_of.hpp>
+#include <async/variant_sender.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace groov::literals;
+
+namespace {
+std::uint32_t ctrl{0x0000'1a05u};
+std::uint32_t status{0x8000'0003u};
+std::uint32_t errors{0x0000'0007u};
+std::size_t num_reads{};
+
+struct bus {
+    template <stdx::ct_string, auto>
+    static auto read(std::uint32_t *addr) -> async::sender auto {
+        return async::just_result_of([=] {
+            ++num_reads;
+            return *addr;
+        });
+    }
+
+    template <stdx::ct_string, auto, auto, auto>
+    static auto write(auto...) -> async::sender auto {
+        return async::just_result_of([] {});
+    }
+};
+
+using F_en = groov::field<"en", bool, 0, 0>;
+using F_count = groov::field<"count", std::uint8_t, 15, 8>;
+using R_ctrl = groov::reg<"ctrl", std::uint32_t, &ctrl, groov::w::replace,
+                          F_en, F_count>;
+
+using F_level = groov::field<"level", std::uint8_t, 1, 0>;
+using F_busy = groov::field<"busy", bool, 31, 31>;
+using R_status = groov::reg<"status", std::uint32_t, &status,
+                            groov::w::replace, F_level, F_busy>;
+using R_errors = groov::reg<"errors", std::uint32_t, &errors>;
+
+using G = groov::group<"group", bus, R_ctrl, R_status, R_errors>;
+constexpr auto grp = G{};
+} // namespace
+
+TEST_CASE("a lazy read reads nothing up front", "[lazy_read]") {
+    num_reads = 0;
+    auto l = groov::lazy_read(grp("ctrl"_r, "status"_r, "errors"_r));
+    CHECK(num_reads == 0);
+    CHECK(not l.is_loaded("ctrl"_r));
+}
+
+TEST_CASE("a lazy read reads a register on first access", "[lazy_read]") {
+    num_reads = 0;
+    auto l = groov::lazy_read(grp("ctrl"_r, "status"_r, "errors"_r));
+    CHECK(l["ctrl.count"_f] == 0x1au);
+    CHECK(num_reads == 1);
+    CHECK(l.is_loaded("ctrl"_r));
+    CHECK(not l.is_loaded("status"_r));
+
+    CHECK(l["ctrl.en"_f]);
+    CHECK(l["ctrl"_r] == 0x0000'1a05u);
+    CHECK(num_reads == 1);
+
+    CHECK(l["status.busy"_f]);
+    CHECK(num_reads == 2);
+}
+
+TEST_CASE("a lazy read remembers what it read", "[lazy_read]") {
+    num_reads = 0;
+    auto l = groov::lazy_read(grp("status.level"_f, "status.busy"_f));
+    CHECK(l["status.level"_f] == 3u);
+    status = 0x0000'0001u;
+    CHECK(l["status.level"_f] == 3u);
+    CHECK(l["status.busy"_f]);
+    CHECK(num_reads == 1);
+    status = 0x8000'0003u;
+}
+
+namespace {
+using R_test = groov::reg<"reg", std::uint32_t, 0x0u, groov::w::replace,
+                          F_en, F_count>;
+using TG = groov::group<"test", groov::test::bus<"test">, R_test>;
+constexpr auto tgrp = TG{};
+} // namespace
+
+TEST_CASE("a lazy read of a bus whose reads may fail", "[lazy_read]") {
+    groov::test::reset_store<TG>();
+    auto l = groov::lazy_read(tgrp / "reg"_r);
+    CHECK(not l["reg.count"_f]);
+    CHECK(not l.is_loaded("reg"_r));
+
+    groov::test::set_value<TG>("reg"_r, 0x0000'4201u);
+    CHECK(l["reg.count"_f] == 0x42u);
+    CHECK(l.is_loaded("reg"_r));
+}
+
+namespace {
+// reads a plain value, but may complete with an error instead
+struct error_bus {
+    static inline bool fail{};
+
+    template <stdx::ct_string, auto>
+    static auto read(std::uint32_t *addr) -> async::sender auto {
+        return async::make_variant_sender(
+            fail, [] { return async::just_error(42); },
+            [=] { return async::just_result_of([=] { return *addr; }); });
+    }
+
+    template <stdx::ct_string, auto, auto, auto>
+    static auto write(auto...) -> async::sender auto {
+        return async::just_result_of([] {});
+    }
+};
+
+using EG = groov::group<"group", error_bus, R_ctrl>;
+constexpr auto egrp = EG{};
+} // namespace
+
+TEST_CASE("a lazy read of a bus whose reads may send an error",
+          "[lazy_read]") {
+    error_bus::fail = true;
+    auto l = groov::lazy_read(egrp / "ctrl"_r);
+    CHECK(not l["ctrl.count"_f]);
+    CHECK(not l.is_loaded("ctrl"_r));
+
+    error_bus::fail = false;
+    CHECK(l["ctrl.count"_f] == 0x1au);
+    CHECK(l.is_loaded("ctrl"_r));
+}
@@ -0,0 +1,153 @@
+#include <groov/config.hpp>
+#include <groov/mmap_iface.hpp>
+#include <groov/mmio_bus.hpp>
+#include <groov/path.hpp>
+#include <groov/read.hpp>
+#include <groov/value_path.hpp>
+#include <groov/write.hpp>
+
+#include <async/just.hpp>
+#include <async/sync_wait.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+using namespace groov::literals;
+
+namespace {
+constexpr auto file_page = std::size_t{4096};
+
+// a file of its own for each test, in the temporary directory
+template <std::size_t N> auto file_path() -> std::string {
+    auto const name = "groov_mmap_iface_test_" + std::to_string(::getpid()) +
+                      "_" + std::to_string(N) + ".bin";
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+auto file_word(char const *path, std::size_t offset) -> std::uint32_t {
+    auto const fd = ::open(path, O_RDONLY);
+    auto word = std::uint32_t{};
+    CHECK(::pread(fd, &word, sizeof(word), static_cast<off_t>(offset)) ==
+          sizeof(word));
+    ::close(fd);
+    return word;
+}
+
+template <std::size_t N> struct config {
+    static inline std::string const file = file_path<N>();
+    static inline char const *path = file.c_str();
+    constexpr static std::size_t size = 0x10;
+    constexpr static std::size_t offset = file_page + 0x20;
+    constexpr static std::uintptr_t base_address = 0x4000'0000;
+};
+
+template <std::size_t N> struct huge_config : config<N> {
+    constexpr static std::size_t huge_page_size = 2 * 1024 * 1024;
+};
+
+struct missing_config {
+    constexpr static char const *path = "/nonexistent/groov_mmap_iface";
+    constexpr static std::size_t size = 0x10;
+};
+
+// Makes the file for Config, two pages of zeroes with the registers in the
+// second one, before a test maps it; and removes it afterwards
+template <typename Config> struct file_fixture {
+    file_fixture() {
+        auto const fd = ::open(Config::path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+        REQUIRE(fd >= 0);
+        REQUIRE(::ftruncate(fd, 2 * file_page) == 0);
+        ::close(fd);
+    }
+    ~file_fixture() { std::filesystem::remove(Config::path); }
+
+    file_fixture(file_fixture const &) = delete;
+    file_fixture(file_fixture &&) = delete;
+    auto operator=(file_fixture const &) -> file_fixture & = delete;
+    auto operator=(file_fixture &&) -> file_fixture & = delete;
+};
+
+using F_lo = groov::field<"lo", std::uint16_t, 15, 0>;
+using F_hi = groov::field<"hi", std::uint16_t, 31, 16>;
+
+using R = groov::reg<"reg", std::uint32_t, 0x4000'0004u, groov::w::replace,
+                     F_lo, F_hi>;
+// registers just past the end of the window and overlapping its start
+using R_past = groov::reg<"past", std::uint32_t, 0x4000'0010u>;
+using R_before = groov::reg<"before", std::uint32_t, 0x3fff'fffcu>;
+
+template <typename Config>
+using G = groov::group<"group", groov::mmio_bus<groov::mmap_iface<Config>>,
+                       R, R_past, R_before>;
+} // namespace
+
+TEST_CASE_METHOD(file_fixture<config<0>>, "write lands in the mapped file",
+                 "[mmap_iface]") {
+    using C = config<0>;
+    CHECK(groov::mmap_iface<C>::mapped());
+
+    constexpr auto grp = G<C>{};
+    CHECK(groov::sync_write(grp("reg"_r = 0x1234'5678u)));
+    CHECK(file_word(C::path, C::offset + 4) == 0x1234'5678u);
+}
+
+TEST_CASE_METHOD(file_fixture<config<1>>, "read comes from the mapped file",
+                 "[mmap_iface]") {
+    constexpr auto grp = G<config<1>>{};
+    CHECK(groov::sync_write(grp("reg"_r = 0xcafe'f00du)));
+    auto r = groov::sync_read(grp / "reg"_r);
+    CHECK(r == 0xcafe'f00du);
+}
+
+TEST_CASE_METHOD(file_fixture<config<2>>,
+                 "partial write preserves the rest of the register",
+                 "[mmap_iface]") {
+    using C = config<2>;
+    constexpr auto grp = G<C>{};
+    CHECK(groov::sync_write(grp("reg"_r = 0xcafe'f00du)));
+    CHECK(groov::sync_write(grp("reg.hi"_f = 0xbeefu)));
+    CHECK(file_word(C::path, C::offset + 4) == 0xbeef'f00du);
+}
+
+TEST_CASE_METHOD(file_fixture<huge_config<3>>,
+                 "huge pages fall back to normal pages", "[mmap_iface]") {
+    using C = huge_config<3>;
+    CHECK(groov::mmap_iface<C>::mapped());
+
+    constexpr auto grp = G<C>{};
+    CHECK(groov::sync_write(grp("reg"_r = 0x600d'600du)));
+    CHECK(file_word(C::path, C::offset + 4) == 0x600d'600du);
+}
+
+TEST_CASE_METHOD(file_fixture<config<4>>,
+                 "access outside the window is reported through the error "
+                 "channel",
+                 "[mmap_iface]") {
+    using C = config<4>;
+    CHECK(groov::mmap_iface<C>::mapped());
+
+    constexpr auto grp = G<C>{};
+    CHECK(not groov::sync_write(grp("past"_r = 1u)));
+    CHECK(not(groov::read(grp / "past"_r) | async::sync_wait()));
+    CHECK(not groov::sync_write(grp("before"_r = 1u)));
+    CHECK(not(groov::read(grp / "before"_r) | async::sync_wait()));
+    CHECK(file_word(C::path, C::offset + 0x10) == 0u);
+}
+
+TEST_CASE("mapping failure is reported through the error channel",
+          "[mmap_iface]") {
+    CHECK(not groov::mmap_iface<missing_config>::mapped());
+    CHECK(groov::mmap_iface<missing_config>::region().error == ENOENT);
+
+    constexpr auto grp = G<missing_config>{};
+    CHECK(not groov::sync_write(grp("reg"_r = 1u)));
+    CHECK(not(groov::read(grp / "reg"_r) | async::sync_wait()));
+}
@@ -1,5 +1,11 @@
+#include <groov/config.hpp>
 #include <groov/mmio_bus.hpp>
 #include <groov/path.hpp>
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/value_path.hpp>
+#include <groov/write.hpp>
+#include <groov/write_spec.hpp>
 
 #include <async/just.hpp>
 #include <async/just_result_of.hpp>
@@ -11,6 +17,7 @@
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 
@@ -241,3 +248,278 @@ TEMPLATE_TEST_CASE("idmask write optimization", "[mmio_bus]", std::uintptr_t,
         CHECK(reg32 == 0x41d0'0dffu);
     }
 }
+
+namespace {
+template <std::size_t LoadCost, std::size_t StoreCost>
+struct costed_iface : iface {
+    template <typename T> constexpr static std::size_t load_cost = LoadCost;
+    template <typename T> constexpr static std::size_t store_cost = StoreCost;
+};
+
+using cheap_store_bus = groov::mmio_bus<costed_iface<10, 1>>;
+using cheap_load_bus = groov::mmio_bus<costed_iface<1, 5>>;
+} // namespace
+
+TEMPLATE_TEST_CASE("cost model chooses multiple subword stores", "[mmio_bus]",
+                   std::uintptr_t, decltype(&reg32)) {
+    auto addr = stdx::bit_cast<TestType>(&reg32);
+
+    reg32 = 0x8765'4321u;
+    iface::num_stores = {};
+    iface::num_loads = {};
+
+    SECTION("two byte stores are cheaper than RMW") {
+        CHECK(cheap_store_bus::write<"", 0xff00'00ffu, 0u, 0u>(
+                  addr, 0xc000'000du) |
+              async::sync_wait());
+
+        CHECK(iface::num_stores == 2);
+        CHECK(iface::num_loads == 0);
+        CHECK(reg32 == 0xc065'430du);
+    }
+
+    SECTION("identity bits are written along with the stores") {
+        CHECK(cheap_store_bus::write<"", 0xff00'000fu, 0xf0u, 0x50u>(
+                  addr, 0xc000'000du) |
+              async::sync_wait());
+
+        CHECK(iface::num_stores == 2);
+        CHECK(iface::num_loads == 0);
+        CHECK(reg32 == 0xc065'435du);
+    }
+
+    SECTION("RMW is cheaper than two byte stores") {
+        CHECK(cheap_load_bus::write<"", 0xff00'00ffu, 0u, 0u>(
+                  addr, 0xc000'000du) |
+              async::sync_wait());
+
+        CHECK(iface::num_stores == 1);
+        CHECK(iface::num_loads == 1);
+        CHECK(reg32 == 0xc065'430du);
+    }
+
+    SECTION("RMW is used when a byte is only partly written") {
+        CHECK(cheap_store_bus::write<"", 0xff00'000fu, 0u, 0u>(
+                  addr, 0xc000'000du) |
+              async::sync_wait());
+
+        CHECK(iface::num_stores == 1);
+        CHECK(iface::num_loads == 1);
+        CHECK(reg32 == 0xc065'432du);
+    }
+
+    SECTION("RMW is used when the interface publishes no costs") {
+        CHECK(bus::write<"", 0xff00'00ffu, 0u, 0u>(addr, 0xc000'000du) |
+              async::sync_wait());
+
+        CHECK(iface::num_stores == 1);
+        CHECK(iface::num_loads == 1);
+        CHECK(reg32 == 0xc065'430du);
+    }
+}
+
+namespace {
+alignas(std::uint64_t) std::array<std::uint32_t, 6> regs{};
+
+struct buffer_iface {
+    static inline std::size_t num_stores{};
+    static inline std::size_t num_loads{};
+    static inline std::size_t last_store_size{};
+    static inline std::size_t last_load_size{};
+
+    static auto to_mem(std::uintptr_t addr) -> std::uintptr_t {
+        return stdx::bit_cast<std::uintptr_t>(regs.data()) + addr;
+    }
+
+    template <std::unsigned_integral T> static auto store(std::uintptr_t addr) {
+        ++num_stores;
+        last_store_size = sizeof(T);
+        return groov::cpp_mem_iface::template store<T>(to_mem(addr));
+    }
+
+    template <std::unsigned_integral T>
+    static auto load(std::uintptr_t addr) -> async::sender auto {
+        ++num_loads;
+        last_load_size = sizeof(T);
+        return groov::cpp_mem_iface::template load<T>(to_mem(addr));
+    }
+
+    template <typename T>
+    constexpr static std::size_t alignment =
+        groov::cpp_mem_iface::template alignment<T>;
+};
+
+struct coalescing_iface : buffer_iface {
+    using coalesce_t = std::uint64_t;
+};
+
+using F0 = groov::field<"field0", std::uint8_t, 0, 0>;
+
+using R0 = groov::reg<"load", std::uint32_t, 0x0u>;
+using R1 = groov::reg<"cmp", std::uint32_t, 0x4u>;
+using R2 = groov::reg<"ctrl", std::uint32_t, 0x8u>;
+using R3 = groov::reg<"status", std::uint32_t, 0xcu>;
+using R4 = groov::reg<"intr", std::uint32_t, 0x10u, groov::w::replace, F0>;
+using R5 = groov::reg<"mask", std::uint32_t, 0x14u>;
+
+using G = groov::group<"timer", groov::mmio_bus<coalescing_iface>, R0, R1,
+                       R2, R3, R4, R5>;
+constexpr auto grp = G{};
+
+using G_no_coalesce = groov::group<"timer", groov::mmio_bus<buffer_iface>,
+                                   R0, R1, R2, R3, R4, R5>;
+constexpr auto grp_no_coalesce = G_no_coalesce{};
+} // namespace
+
+TEST_CASE("mmio_bus coalescing is opt-in", "[mmio_bus]") {
+    STATIC_CHECK(
+        groov::can_coalesce<groov::mmio_bus<coalescing_iface>, std::uint64_t>(
+            0x8u));
+    STATIC_CHECK(not groov::can_coalesce<groov::mmio_bus<coalescing_iface>,
+                                         std::uint64_t>(0x4u));
+    STATIC_CHECK(
+        not groov::can_coalesce<groov::mmio_bus<buffer_iface>, std::uint64_t>(
+            0x8u));
+    STATIC_CHECK(not groov::can_coalesce<groov::mmio_bus<>, std::uint64_t>(0));
+}
+
+TEST_CASE("coalesce writes to adjacent registers", "[mmio_bus]") {
+    using namespace groov::literals;
+    regs = {};
+    buffer_iface::num_stores = {};
+    buffer_iface::num_loads = {};
+
+    CHECK(sync_write(grp("load"_r = 0x1234'5678u, "cmp"_r = 0xcafe'f00du)));
+    CHECK(buffer_iface::num_stores == 1);
+    CHECK(buffer_iface::num_loads == 0);
+    CHECK(buffer_iface::last_store_size == sizeof(std::uint64_t));
+    CHECK(regs[0] == 0x1234'5678u);
+    CHECK(regs[1] == 0xcafe'f00du);
+}
+
+TEST_CASE("coalesce writes regardless of path order", "[mmio_bus]") {
+    using namespace groov::literals;
+    regs = {};
+    buffer_iface::num_stores = {};
+
+    CHECK(sync_write(grp("status"_r = 0xd00du, "ctrl"_r = 0xc001u)));
+    CHECK(buffer_iface::num_stores == 1);
+    CHECK(regs[2] == 0xc001u);
+    CHECK(regs[3] == 0xd00du);
+}
+
+TEST_CASE("coalesce writes to four adjacent registers", "[mmio_bus]") {
+    using namespace groov::literals;
+    regs = {};
+    buffer_iface::num_stores = {};
+
+    CHECK(sync_write(grp("load"_r = 1u, "cmp"_r = 2u, "ctrl"_r = 3u,
+                         "status"_r = 4u)));
+    CHECK(buffer_iface::num_stores == 2);
+    CHECK(buffer_iface::last_store_size == sizeof(std::uint64_t));
+    CHECK(regs == std::array<std::uint32_t, 6>{1u, 2u, 3u, 4u, 0u, 0u});
+}
+
+TEST_CASE("writes are not coalesced across an alignment boundary",
+          "[mmio_bus]") {
+    using namespace groov::literals;
+    regs = {};
+    buffer_iface::num_stores = {};
+
+    CHECK(sync_write(grp("cmp"_r = 2u, "ctrl"_r = 3u)));
+    CHECK(buffer_iface::num_stores == 2);
+    CHECK(buffer_iface::last_store_size == sizeof(std::uint32_t));
+    CHECK(regs[1] == 2u);
+    CHECK(regs[2] == 3u);
+}
+
+TEST_CASE("writes are not coalesced when a register needs RMW",
+          "[mmio_bus]") {
+    using namespace groov::literals;
+    regs = {0u, 0u, 0u, 0u, 0xffff'fff0u, 0u};
+    buffer_iface::num_stores = {};
+    buffer_iface::num_loads = {};
+
+    CHECK(sync_write(grp("intr.field0"_f = 1u, "mask"_r = 1u)));
+    CHECK(buffer_iface::num_stores == 2);
+    CHECK(buffer_iface::num_loads == 1);
+    CHECK(regs[4] == 0xffff'fff1u);
+    CHECK(regs[5] == 1u);
+}
+
+TEST_CASE("writes are not coalesced unless the interface opts in",
+          "[mmio_bus]") {
+    using namespace groov::literals;
+    regs = {};
+    buffer_iface::num_stores = {};
+
+    CHECK(sync_write(
+        grp_no_coalesce("load"_r = 0x1234'5678u, "cmp"_r = 0xcafe'f00du)));
+    CHECK(buffer_iface::num_stores == 2);
+    CHECK(buffer_iface::last_store_size == sizeof(std::uint32_t));
+    CHECK(regs[0] == 0x1234'5678u);
+    CHECK(regs[1] == 0xcafe'f00du);
+}
+
+TEST_CASE("coalesce reads of adjacent registers", "[mmio_bus]") {
+    using namespace groov::literals;
+    regs = {0x1234'5678u, 0xcafe'f00du, 0u, 0u, 0u, 0u};
+    buffer_iface::num_loads = {};
+
+    auto r = sync_read(grp("cmp"_r, "load"_r));
+    CHECK(buffer_iface::num_loads == 1);
+    CHECK(buffer_iface::last_load_size == sizeof(std::uint64_t));
+    CHECK(r["load"_r] == 0x1234'5678u);
+    CHECK(r["cmp"_r] == 0xcafe'f00du);
+}
+
+TEST_CASE("coalesce reads of fields in adjacent registers", "[mmio_bus]") {
+    using namespace groov::literals;
+    regs = {0u, 0u, 0u, 0u, 0xffff'fff1u, 0xa5u};
+    buffer_iface::num_loads = {};
+
+    auto r = sync_read(grp("intr.field0"_f, "mask"_r));
+    CHECK(buffer_iface::num_loads == 1);
+    CHECK(r["intr.field0"_f] == 1u);
+    CHECK(r["mask"_r] == 0xa5u);
+}
+
+TEST_CASE("coalesce reads of four adjacent registers", "[mmio_bus]") {
+    using namespace groov::literals;
+    regs = {1u, 2u, 3u, 4u, 0u, 0u};
+    buffer_iface::num_loads = {};
+
+    auto r = sync_read(grp("load"_r, "cmp"_r, "ctrl"_r, "status"_r));
+    CHECK(buffer_iface::num_loads == 2);
+    CHECK(buffer_iface::last_load_size == sizeof(std::uint64_t));
+    CHECK(r["load"_r] == 1u);
+    CHECK(r["cmp"_r] == 2u);
+    CHECK(r["ctrl"_r] == 3u);
+    CHECK(r["status"_r] == 4u);
+}
+
+TEST_CASE("reads are not coalesced across an alignment boundary",
+          "[mmio_bus]") {
+    using namespace groov::literals;
+    regs = {0u, 2u, 3u, 0u, 0u, 0u};
+    buffer_iface::num_loads = {};
+
+    auto r = sync_read(grp("cmp"_r, "ctrl"_r));
+    CHECK(buffer_iface::num_loads == 2);
+    CHECK(buffer_iface::last_load_size == sizeof(std::uint32_t));
+    CHECK(r["cmp"_r] == 2u);
+    CHECK(r["ctrl"_r] == 3u);
+}
+
+TEST_CASE("reads are not coalesced unless the interface opts in",
+          "[mmio_bus]") {
+    using namespace groov::literals;
+    regs = {0x1234'5678u, 0xcafe'f00du, 0u, 0u, 0u, 0u};
+    buffer_iface::num_loads = {};
+
+    auto r = sync_read(grp_no_coalesce("load"_r, "cmp"_r));
+    CHECK(buffer_iface::num_loads == 2);
+    CHECK(buffer_iface::last_load_size == sizeof(std::uint32_t));
+    CHECK(r["load"_r] == 0x1234'5678u);
+    CHECK(r["cmp"_r] == 0xcafe'f00du);
+}
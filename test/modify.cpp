@@ -0,0 +1,195 @@
+#include <groov/config.hpp>
+#include <groov/identity.hpp>
+#include <groov/mmio_bus.hpp>
+#include <groov/modify.hpp>
+#include <groov/path.hpp>
+#include <groov/read_spec.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+#include <async/sync_wait.hpp>
+#include <async/variant_sender.hpp>
+
+#include <stdx/bit.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+using namespace groov::literals;
+
+namespace {
+alignas(std::uint64_t) std::array<std::uint32_t, 2> regs{};
+
+struct iface {
+    static inline std::size_t num_stores{};
+    static inline std::size_t num_loads{};
+
+    static auto to_mem(std::uintptr_t addr) -> std::uintptr_t {
+        return stdx::bit_cast<std::uintptr_t>(regs.data()) + addr;
+    }
+
+    template <std::unsigned_integral T> static auto store(std::uintptr_t addr) {
+        ++num_stores;
+        return groov::cpp_mem_iface::template store<T>(to_mem(addr));
+    }
+
+    template <std::unsigned_integral T>
+    static auto load(std::uintptr_t addr) -> async::sender auto {
+        ++num_loads;
+        return groov::cpp_mem_iface::template load<T>(to_mem(addr));
+    }
+
+    template <typename T>
+    constexpr static std::size_t alignment =
+        groov::cpp_mem_iface::template alignment<T>;
+};
+
+struct coalescing_iface : iface {
+    using coalesce_t = std::uint64_t;
+};
+
+// loads fail when asked to
+struct failing_iface : iface {
+    static inline bool fail{};
+
+    template <std::unsigned_integral T>
+    static auto load(std::uintptr_t addr) -> async::sender auto {
+        return async::make_variant_sender(
+            fail, [] { return async::just_error(42); },
+            [=] { return iface::load<T>(addr); });
+    }
+};
+
+using F_en = groov::field<"en", std::uint8_t, 0, 0>;
+using F_mode = groov::field<"mode", std::uint8_t, 7, 1>;
+using F_count = groov::field<"count", std::uint32_t, 30, 8>;
+using F_status =
+    groov::field<"status", std::uint8_t, 31, 31, groov::w::one_to_clear>;
+
+using R_ctrl = groov::reg<"ctrl", std::uint32_t, 0x0u, groov::w::replace, F_en,
+                          F_mode, F_count, F_status>;
+using R_cfg = groov::reg<"cfg", std::uint32_t, 0x4u, groov::w::replace, F_en,
+                         F_mode, F_count, F_status>;
+
+using G = groov::group<"group", groov::mmio_bus<iface>, R_ctrl, R_cfg>;
+constexpr auto grp = G{};
+
+using G_coalesce =
+    groov::group<"group", groov::mmio_bus<coalescing_iface>, R_ctrl, R_cfg>;
+constexpr auto grp_coalesce = G_coalesce{};
+
+using G_failing =
+    groov::group<"group", groov::mmio_bus<failing_iface>, R_ctrl, R_cfg>;
+constexpr auto grp_failing = G_failing{};
+
+auto reset() {
+    regs = {};
+    iface::num_stores = {};
+    iface::num_loads = {};
+}
+} // namespace
+
+TEST_CASE("modify a field with one load and one store", "[modify]") {
+    reset();
+    regs[0] = 0x0000'0a41u;
+
+    CHECK(groov::modify(grp("ctrl.mode"_f),
+                        [](auto &spec) { spec["ctrl.mode"_f] += 1; }) |
+          async::sync_wait());
+    CHECK(iface::num_loads == 1);
+    CHECK(iface::num_stores == 1);
+    CHECK(regs[0] == 0x0000'0a43u);
+}
+
+TEST_CASE("modify writes identity values to unmodified fields", "[modify]") {
+    reset();
+    regs[0] = 0x8000'0000u;
+
+    CHECK(groov::modify(grp("ctrl.en"_f),
+                        [](auto &spec) { spec["ctrl.en"_f] = 1; }) |
+          async::sync_wait());
+    CHECK(iface::num_loads == 1);
+    CHECK(regs[0] == 0x1u);
+}
+
+TEST_CASE("modify several registers", "[modify]") {
+    reset();
+    regs[0] = 0x100u;
+    regs[1] = 0x200u;
+
+    CHECK(groov::modify(grp("ctrl.count"_f, "cfg.count"_f),
+                        [](auto &spec) {
+                            spec["ctrl.count"_f] += 1;
+                            spec["cfg.count"_f] += 1;
+                        }) |
+          async::sync_wait());
+    CHECK(iface::num_loads == 2);
+    CHECK(iface::num_stores == 2);
+    CHECK(regs[0] == 0x200u);
+    CHECK(regs[1] == 0x300u);
+}
+
+TEST_CASE("modify coalesces accesses on a capable bus", "[modify]") {
+    reset();
+    regs[0] = 0x100u;
+    regs[1] = 0x200u;
+
+    CHECK(groov::modify(grp_coalesce("ctrl.en"_f, "cfg.en"_f),
+                        [](auto &spec) {
+                            spec["ctrl.en"_f] = 1;
+                            spec["cfg.en"_f] = 1;
+                        }) |
+          async::sync_wait());
+    CHECK(iface::num_loads == 1);
+    CHECK(iface::num_stores == 1);
+    CHECK(regs[0] == 0x101u);
+    CHECK(regs[1] == 0x201u);
+}
+
+TEST_CASE("modify is pipeable", "[modify]") {
+    reset();
+    regs[1] = 0xf0u;
+
+    auto r = async::just(grp("cfg.mode"_f)) |
+             groov::modify([](auto &spec) { spec["cfg.mode"_f] = 0; }) |
+             async::sync_wait();
+    CHECK(r);
+    CHECK(iface::num_loads == 1);
+    CHECK(regs[1] == 0u);
+}
+
+TEST_CASE("modify in a critical section", "[modify]") {
+    reset();
+
+    CHECK(groov::modify<groov::in_critical_section>(
+              grp("ctrl.en"_f), [](auto &spec) { spec["ctrl.en"_f] = 1; }) |
+          async::sync_wait());
+    CHECK(iface::num_loads == 1);
+    CHECK(regs[0] == 0x1u);
+}
+
+TEST_CASE("modify in a critical section sends an error if a read fails",
+          "[modify]") {
+    reset();
+    regs[0] = 0x10u;
+
+    auto const modify = [] {
+        return groov::modify<groov::in_critical_section>(
+                   grp_failing("ctrl.en"_f),
+                   [](auto &spec) { spec["ctrl.en"_f] = 1; }) |
+               async::sync_wait();
+    };
+
+    failing_iface::fail = true;
+    CHECK(not modify());
+    CHECK(iface::num_stores == 0);
+    CHECK(regs[0] == 0x10u);
+
+    failing_iface::fail = false;
+    CHECK(modify());
+    CHECK(regs[0] == 0x11u);
+}
@@ -0,0 +1,110 @@
+#include <groov/alias.hpp>
+#include <groov/config.hpp>
+#include <groov/mmio_bus.hpp>
+#include <groov/path.hpp>
+#include <groov/plan.hpp>
+#include <groov/shadow.hpp>
+#include <groov/value_path.hpp>
+#include <groov/write.hpp>
+#include <groov/write_spec.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+#include <async/then.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+using namespace groov::literals;
+
+namespace {
+struct iface {
+    template <std::unsigned_integral T> static auto store(std::uintptr_t) {
+        return async::then([](T) {});
+    }
+
+    template <std::unsigned_integral T>
+    static auto load(std::uintptr_t) -> async::sender auto {
+        return async::just(T{});
+    }
+
+    template <typename T> constexpr static std::size_t alignment = alignof(T);
+};
+
+struct coalescing_iface : iface {
+    using coalesce_t = std::uint64_t;
+};
+
+using F_en = groov::field<"en", std::uint8_t, 0, 0>;
+using F_mode = groov::field<"mode", std::uint8_t, 7, 4>;
+using F_hi = groov::field<"hi", std::uint8_t, 15, 8>;
+using F_status = groov::field<"status", bool, 31, 31, groov::w::one_to_clear>;
+using F_rest = groov::field<"rest", std::uint32_t, 31, 8>;
+
+using R_ctrl =
+    groov::reg<"ctrl", std::uint32_t, 0x10u, groov::w::replace, F_en, F_mode>;
+using R_data = groov::reg<"data", std::uint32_t, 0x14u, groov::w::replace,
+                          F_hi, F_status>;
+using R_set =
+    groov::reg<"set", std::uint32_t, 0x18u, groov::w::replace,
+               groov::attr::set_clear_aliases<
+                   0x100, 0x200, groov::attr::multi_bit_writes::split>,
+               F_en, F_mode, F_rest>;
+using R_next = groov::reg<"next", std::uint32_t, 0x20u>;
+using R_last = groov::reg<"last", std::uint32_t, 0x24u>;
+
+using G = groov::group<"group", groov::mmio_bus<iface>, R_ctrl, R_data, R_set,
+                       R_next, R_last>;
+constexpr auto grp = G{};
+
+using G_coalesce = groov::group<"group", groov::mmio_bus<coalescing_iface>,
+                                R_ctrl, R_data, R_set, R_next, R_last>;
+constexpr auto grp_coalesce = G_coalesce{};
+} // namespace
+
+TEST_CASE("partial write is planned as a read-modify-write", "[plan]") {
+    constexpr auto p = groov::plan_of(grp("ctrl.en"_f = true));
+    STATIC_CHECK(p.size() == 1);
+    STATIC_CHECK(p[0] == groov::bus_op{"ctrl", 0x10u, sizeof(std::uint32_t),
+                                       groov::bus_access::read_modify_write});
+    STATIC_CHECK(p.num_loads() == 1);
+    STATIC_CHECK(p.num_stores() == 1);
+}
+
+TEST_CASE("write covering a subword is planned as a narrow store",
+          "[plan]") {
+    constexpr auto p = groov::plan_of(grp("data.hi"_f = 1u));
+    STATIC_CHECK(p.num_loads() == 0);
+    STATIC_CHECK(p.size() == 1);
+    STATIC_CHECK(p[0] == groov::bus_op{"data", 0x15u, sizeof(std::uint8_t),
+                                       groov::bus_access::store});
+}
+
+TEST_CASE("plan of a spec type", "[plan]") {
+    using spec_t = decltype(grp("ctrl.mode"_f = 1u, "next"_r = 0u));
+    constexpr auto p = groov::plan_of<spec_t>();
+    STATIC_CHECK(p.size() == 2);
+    STATIC_CHECK(p[0].name == std::string_view{"ctrl"});
+    STATIC_CHECK(p[1] == groov::bus_op{"next", 0x20u, sizeof(std::uint32_t),
+                                       groov::bus_access::store});
+}
+
+TEST_CASE("aliased write is planned as stores to the aliases", "[plan]") {
+    constexpr auto p = groov::plan_of(grp("set.en"_f = true, "set.mode"_f = 1u));
+    STATIC_CHECK(p.num_loads() == 0);
+    STATIC_CHECK(p.size() == 2);
+    STATIC_CHECK(p[0].address == 0x218u);
+    STATIC_CHECK(p[1].address == 0x118u);
+}
+
+TEST_CASE("coalesced write is planned as one wide store", "[plan]") {
+    constexpr auto p =
+        groov::plan_of(grp_coalesce("last"_r = 0u, "next"_r = 0u));
+    STATIC_CHECK(p.size() == 1);
+    STATIC_CHECK(p[0] == groov::bus_op{"next", 0x20u, sizeof(std::uint64_t),
+                                       groov::bus_access::store});
+}
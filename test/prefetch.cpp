@@ -0,0 +1,173 @@
+#include <groov/config.hpp>
+#include <groov/path.hpp>
+#include <groov/prefetch.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/test.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+#include <async/just_result_of.hpp>
+#include <async/schedulers/thread_scheduler.hpp>
+#include <async/then.hpp>
+#include <async/variant_sender.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace groov::literals;
+
+namespace {
+std::uint32_t ctrl{0x0000'1a05u};
+std::uint32_t status{0x8000'0003u};
+std::size_t num_reads{};
+
+struct bus {
+    template <stdx::ct_string, auto>
+    static auto read(std::uint32_t *addr) -> async::sender auto {
+        return async::just_result_of([=] {
+            ++num_reads;
+            return *addr;
+        });
+    }
+
+    template <stdx::ct_string, auto, auto, auto>
+    static auto write(auto...) -> async::sender auto {
+        return async::just_result_of([] {});
+    }
+};
+
+// reads complete on another thread
+struct async_bus {
+    template <stdx::ct_string, auto>
+    static auto read(std::uint32_t *addr) -> async::sender auto {
+        return async::thread_scheduler{}.schedule() |
+               async::then([=] { return *addr; });
+    }
+
+    template <stdx::ct_string, auto, auto, auto>
+    static auto write(auto...) -> async::sender auto {
+        return async::just_result_of([] {});
+    }
+};
+
+// reads fail when asked to
+struct failing_bus {
+    static inline bool fail{};
+
+    template <stdx::ct_string, auto>
+    static auto read(std::uint32_t *addr) -> async::sender auto {
+        return async::make_variant_sender(
+            fail, [] { return async::just_error(42); },
+            [=] { return async::just_result_of([=] { return *addr; }); });
+    }
+
+    template <stdx::ct_string, auto, auto, auto>
+    static auto write(auto...) -> async::sender auto {
+        return async::just_result_of([] {});
+    }
+};
+
+using F_en = groov::field<"en", bool, 0, 0>;
+using F_count = groov::field<"count", std::uint8_t, 15, 8>;
+using R_ctrl = groov::reg<"ctrl", std::uint32_t, &ctrl, groov::w::replace,
+                          F_en, F_count>;
+
+using F_level = groov::field<"level", std::uint8_t, 1, 0>;
+using F_busy = groov::field<"busy", bool, 31, 31>;
+using R_status = groov::reg<"status", std::uint32_t, &status,
+                            groov::w::replace, F_level, F_busy>;
+
+using G = groov::group<"group", bus, R_ctrl, R_status>;
+constexpr auto grp = G{};
+
+using AG = groov::group<"group", async_bus, R_ctrl, R_status>;
+constexpr auto agrp = AG{};
+
+using FG = groov::group<"group", failing_bus, R_ctrl, R_status>;
+constexpr auto fgrp = FG{};
+} // namespace
+
+TEST_CASE("prefetch issues the read straight away", "[prefetch]") {
+    num_reads = 0;
+    auto h = groov::prefetch(grp("ctrl"_r, "status"_r));
+    CHECK(num_reads == 2);
+    CHECK(h.is_ready());
+}
+
+TEST_CASE("collect returns the values that were read", "[prefetch]") {
+    auto h = groov::prefetch(grp("ctrl.count"_f, "status.busy"_f));
+    auto r = h | groov::collect();
+    CHECK(r["ctrl.count"_f] == 0x1a);
+    CHECK(r["status.busy"_f]);
+}
+
+TEST_CASE("collect returns the values as they were at prefetch",
+          "[prefetch]") {
+    ctrl = 0x0000'1a05u;
+    auto h = groov::prefetch(grp / "ctrl.count"_f);
+    ctrl = 0x0000'ff05u;
+    CHECK((h | groov::collect()) == 0x1a);
+    ctrl = 0x0000'1a05u;
+}
+
+TEST_CASE("prefetch can convert the result", "[prefetch]") {
+    auto h = groov::prefetch<std::uint32_t>(grp / "ctrl"_r);
+    CHECK((h | groov::collect()) == ctrl);
+}
+
+TEST_CASE("collect waits for an asynchronous bus", "[prefetch]") {
+    auto h = groov::prefetch(agrp("ctrl.en"_f, "status.level"_f));
+    auto r = h | groov::collect();
+    CHECK(h.is_ready());
+    CHECK(r["ctrl.en"_f]);
+    CHECK(r["status.level"_f] == 3);
+}
+
+TEST_CASE("collect waits with the strategy it is given", "[prefetch]") {
+    auto h = groov::prefetch(agrp / "ctrl.count"_f, groov::backoff<>{});
+    CHECK((h | groov::collect()) == 0x1a);
+
+    auto r = groov::prefetch<std::uint32_t>(
+                 agrp / "ctrl"_r, groov::yield_to{async::thread_scheduler{}}) |
+             groov::collect();
+    CHECK(r == ctrl);
+}
+
+TEST_CASE("collect returns an empty optional for a failed read",
+          "[prefetch]") {
+    failing_bus::fail = false;
+    auto r = groov::prefetch(fgrp / "ctrl.count"_f) | groov::collect();
+    REQUIRE(r.has_value());
+    CHECK(*r == 0x1a);
+
+    failing_bus::fail = true;
+    CHECK(not(groov::prefetch(fgrp / "ctrl.count"_f) | groov::collect()));
+}
+
+TEST_CASE("a prefetch handle may be dropped without collecting",
+          "[prefetch]") {
+    {
+        auto h = groov::prefetch(agrp / "ctrl"_r);
+    }
+    CHECK(ctrl == 0x0000'1a05u);
+}
+
+namespace {
+using R_test = groov::reg<"reg", std::uint32_t, 0x0u, groov::w::replace,
+                          F_en, F_count>;
+using TG = groov::group<"test", groov::test::bus<"test">, R_test>;
+constexpr auto tgrp = TG{};
+} // namespace
+
+TEST_CASE("prefetch works with a bus whose reads may fail", "[prefetch]") {
+    groov::test::reset_store<TG>();
+    auto h = groov::prefetch(tgrp / "reg.count"_f);
+    CHECK(not(h | groov::collect()));
+
+    groov::test::set_value<TG>("reg"_r, 0x0000'4201u);
+    auto r = groov::prefetch(tgrp / "reg.count"_f) | groov::collect();
+    REQUIRE(r.has_value());
+    CHECK(*r == 0x42u);
+}
@@ -10,7 +10,11 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <array>
+#include <bit>
+#include <concepts>
 #include <cstdint>
+#include <cstring>
 
 namespace {
 struct bus {
@@ -344,3 +348,88 @@ TEST_CASE("read a field in a register containing WO fields which won't be read "
     auto r = sync_read(grp_be / "reg4.field0"_r);
     CHECK(r["reg4.field0"_r] == 42);
 }
+
+namespace {
+alignas(std::uint32_t) std::array<std::uint8_t, 8> coalesce_data{};
+
+struct coalescing_bus {
+    static inline int num_reads{};
+    static inline std::uint64_t last_mask{};
+
+    template <std::unsigned_integral T>
+    constexpr static auto can_coalesce(std::uintptr_t addr) -> bool {
+        return addr % sizeof(T) == 0;
+    }
+
+    template <stdx::ct_string, auto Mask>
+    static auto read(std::uintptr_t addr) -> async::sender auto {
+        return async::just_result_of([=] {
+            ++num_reads;
+            last_mask = Mask;
+            decltype(Mask) value{};
+            std::memcpy(&value, coalesce_data.data() + addr, sizeof(value));
+            return value;
+        });
+    }
+
+    struct dummy_sender {
+        using is_sender = void;
+    };
+    template <stdx::ct_string, auto...>
+    static auto write(auto...) -> async::sender auto {
+        return dummy_sender{};
+    }
+};
+
+using F_lo = groov::field<"f", std::uint8_t, 3, 0>;
+using R_lo = groov::reg<"lo", std::uint16_t, 0x0u, groov::w::replace, F_lo>;
+using R_hi = groov::reg<"hi", std::uint16_t, 0x2u>;
+using R_next = groov::reg<"next", std::uint16_t, 0x4u>;
+
+using G_coalesce =
+    groov::group<"group", coalescing_bus, R_lo, R_hi, R_next>;
+constexpr auto grp_coalesce = G_coalesce{};
+
+using R_fifo = groov::reg<"fifo", std::uint16_t, 0x2u,
+                          groov::r::pop<groov::w::replace>>;
+using G_fifo = groov::group<"group", coalescing_bus, R_lo, R_fifo>;
+constexpr auto grp_fifo = G_fifo{};
+} // namespace
+
+TEST_CASE("reads of adjacent registers are coalesced", "[read]") {
+    using namespace groov::literals;
+    coalesce_data = {0x0du, 0xd0u, 0xfeu, 0xcau, 0u, 0u, 0u, 0u};
+    coalescing_bus::num_reads = {};
+
+    auto r = sync_read(grp_coalesce("hi"_r, "lo.f"_f));
+    CHECK(coalescing_bus::num_reads == 1);
+    CHECK(r["hi"_r] == 0xcafeu);
+    CHECK(r["lo.f"_f] == 0xdu);
+    if constexpr (std::endian::native == std::endian::little) {
+        CHECK(coalescing_bus::last_mask == 0xffff'000fu);
+    }
+}
+
+TEST_CASE("reads of registers are not coalesced when the bus refuses",
+          "[read]") {
+    using namespace groov::literals;
+    coalesce_data = {0u, 0u, 0x01u, 0x02u, 0x03u, 0x04u, 0u, 0u};
+    coalescing_bus::num_reads = {};
+
+    auto r = sync_read(grp_coalesce("hi"_r, "next"_r));
+    CHECK(coalescing_bus::num_reads == 2);
+    CHECK(r["hi"_r] == 0x0201u);
+    CHECK(r["next"_r] == 0x0403u);
+}
+
+TEST_CASE("reads of registers with side effects on read are not coalesced",
+          "[read]") {
+    using namespace groov::literals;
+    coalesce_data = {0x0du, 0xd0u, 0xfeu, 0xcau, 0u, 0u, 0u, 0u};
+    coalescing_bus::num_reads = {};
+
+    auto r = sync_read(grp_fifo("fifo"_r, "lo"_r));
+    CHECK(coalescing_bus::num_reads == 2);
+    CHECK(r["fifo"_r] == 0xcafeu);
+    CHECK(r["lo"_r] == 0xd00du);
+}
@@ -0,0 +1,125 @@
+#include <groov/config.hpp>
+#include <groov/path.hpp>
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/test.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+#include <async/just_result_of.hpp>
+#include <async/sync_wait.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <optional>
+
+using namespace groov::literals;
+
+namespace {
+std::uint32_t ctrl{0x0000'1a05u};
+std::uint32_t status{0x8000'0003u};
+
+struct bus {
+    template <stdx::ct_string, auto>
+    static auto read(std::uint32_t *addr) -> async::sender auto {
+        return async::just_result_of([=] { return *addr; });
+    }
+
+    template <stdx::ct_string, auto, auto, auto>
+    static auto write(auto...) -> async::sender auto {
+        return async::just_result_of([] {});
+    }
+};
+
+enum struct mode : std::uint8_t { off, slow, fast };
+
+using F_en = groov::field<"en", bool, 0, 0>;
+using F_mode = groov::field<"mode", mode, 2, 1>;
+using F_count = groov::field<"count", std::uint8_t, 15, 8>;
+using R_ctrl = groov::reg<"ctrl", std::uint32_t, &ctrl, groov::w::replace,
+                          F_en, F_mode, F_count>;
+
+using F_level = groov::field<"level", std::uint8_t, 1, 0>;
+using F_busy = groov::field<"busy", bool, 31, 31>;
+using R_status = groov::reg<"status", std::uint32_t, &status,
+                            groov::w::replace, F_level, F_busy>;
+
+using G = groov::group<"group", bus, R_ctrl, R_status>;
+constexpr auto grp = G{};
+
+struct telemetry {
+    std::uint8_t count;
+    mode m;
+    bool busy;
+};
+} // namespace
+
+TEST_CASE("read into an aggregate, one member per path", "[read_as]") {
+    auto r = groov::read_as<telemetry>(grp("ctrl.count"_f, "ctrl.mode"_f,
+                                           "status.busy"_f)) |
+             async::sync_wait();
+    REQUIRE(r);
+    auto const t = get<0>(*r);
+    CHECK(t.count == 0x1au);
+    CHECK(t.m == mode::fast);
+    CHECK(t.busy);
+}
+
+TEST_CASE("read into struct members by explicit mapping", "[read_as]") {
+    using M = groov::members<&telemetry::busy, &telemetry::count>;
+    auto r = groov::read_as<M>(grp("status.busy"_f, "ctrl.count"_f)) |
+             async::sync_wait();
+    REQUIRE(r);
+    auto const t = get<0>(*r);
+    CHECK(t.busy);
+    CHECK(t.count == 0x1au);
+    CHECK(t.m == mode::off);
+}
+
+TEST_CASE("read into an aggregate with a whole register", "[read_as]") {
+    struct raw {
+        std::uint32_t ctrl;
+        std::uint8_t level;
+    };
+    auto r = groov::read_as<raw>(grp("ctrl"_r, "status.level"_f)) |
+             async::sync_wait();
+    REQUIRE(r);
+    CHECK(get<0>(*r).ctrl == 0x0000'1a05u);
+    CHECK(get<0>(*r).level == 3u);
+}
+
+TEST_CASE("read_as is pipeable into an aggregate", "[read_as]") {
+    auto r = async::just(grp("ctrl.count"_f, "ctrl.mode"_f, "status.busy"_f)) |
+             groov::read_as<telemetry>() | async::sync_wait();
+    REQUIRE(r);
+    CHECK(get<0>(*r).count == 0x1au);
+}
+
+namespace {
+using R_test = groov::reg<"reg", std::uint32_t, 0x0u, groov::w::replace,
+                          F_en, F_count>;
+using TG = groov::group<"test", groov::test::bus<"test">, R_test>;
+constexpr auto tgrp = TG{};
+
+struct small {
+    bool en;
+    std::uint8_t count;
+};
+} // namespace
+
+TEST_CASE("a failed read into an aggregate", "[read_as]") {
+    groov::test::reset_store<TG>();
+    auto r = groov::read_as<small>(tgrp("reg.en"_f, "reg.count"_f)) |
+             async::sync_wait();
+    REQUIRE(r);
+    CHECK(not get<0>(*r));
+
+    groov::test::set_value<TG>("reg"_r, 0x0000'4201u);
+    r = groov::read_as<small>(tgrp("reg.en"_f, "reg.count"_f)) |
+        async::sync_wait();
+    REQUIRE(r);
+    REQUIRE(get<0>(*r));
+    CHECK(get<0>(*r)->en);
+    CHECK(get<0>(*r)->count == 0x42u);
+}
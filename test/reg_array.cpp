@@ -0,0 +1,165 @@
+#include <groov/config.hpp>
+#include <groov/lazy_read.hpp>
+#include <groov/mmio_bus.hpp>
+#include <groov/modify.hpp>
+#include <groov/path.hpp>
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/value_path.hpp>
+#include <groov/write.hpp>
+#include <groov/write_spec.hpp>
+
+#include <async/concepts.hpp>
+#include <async/sync_wait.hpp>
+
+#include <stdx/bit.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+using namespace groov::literals;
+
+namespace {
+// four channels of four registers each, then a global control register
+alignas(std::uint64_t) std::array<std::uint32_t, 17> regs{};
+
+struct iface {
+    static inline std::size_t num_stores{};
+    static inline std::size_t num_loads{};
+
+    static auto to_mem(std::uintptr_t addr) -> std::uintptr_t {
+        return stdx::bit_cast<std::uintptr_t>(regs.data()) + addr;
+    }
+
+    template <std::unsigned_integral T> static auto store(std::uintptr_t addr) {
+        ++num_stores;
+        return groov::cpp_mem_iface::template store<T>(to_mem(addr));
+    }
+
+    template <std::unsigned_integral T>
+    static auto load(std::uintptr_t addr) -> async::sender auto {
+        ++num_loads;
+        return groov::cpp_mem_iface::template load<T>(to_mem(addr));
+    }
+
+    template <typename T>
+    constexpr static std::size_t alignment =
+        groov::cpp_mem_iface::template alignment<T>;
+};
+
+using F_en = groov::field<"en", std::uint8_t, 0, 0>;
+using F_mode = groov::field<"mode", std::uint8_t, 7, 1>;
+using F_count = groov::field<"count", std::uint32_t, 31, 8>;
+
+using R_ch = groov::reg<"ch", std::uint32_t, 0x4u, groov::w::replace, F_en,
+                        F_mode, F_count>;
+using A_ch = groov::reg_array<"CH", 4, 0x10, R_ch>;
+using R_global = groov::reg<"global", std::uint32_t, 0x40u>;
+
+using G = groov::group<"group", groov::mmio_bus<iface>, A_ch, R_global>;
+constexpr auto grp = G{};
+
+auto reset() {
+    regs = {};
+    iface::num_stores = {};
+    iface::num_loads = {};
+}
+} // namespace
+
+TEST_CASE("register array elements are strided from the base address",
+          "[reg_array]") {
+    STATIC_REQUIRE(groov::register_array<A_ch>);
+    STATIC_REQUIRE(not groov::register_array<R_ch>);
+    CHECK(groov::detail::element_address<A_ch>(0) == 0x4u);
+    CHECK(groov::detail::element_address<A_ch>(3) == 0x34u);
+}
+
+TEST_CASE("read an element of a register array", "[reg_array]") {
+    reset();
+    regs[5] = 42;
+    regs[9] = 17;
+    CHECK(groov::sync_read(grp / "CH"_r[1]) == 42u);
+    CHECK(groov::sync_read(grp / "CH"_r[2]) == 17u);
+    CHECK(iface::num_loads == 2);
+}
+
+TEST_CASE("read a field of an element", "[reg_array]") {
+    reset();
+    regs[13] = 0x0000'0a05u;
+    auto const i = std::size_t{3};
+    CHECK(groov::sync_read(grp / "CH.mode"_f[i]) == 2u);
+}
+
+TEST_CASE("write an element of a register array", "[reg_array]") {
+    reset();
+    for (auto i = std::size_t{}; i < 4; ++i) {
+        groov::sync_write(grp("CH"_r[i] = i + 1));
+    }
+    CHECK(regs[1] == 1u);
+    CHECK(regs[5] == 2u);
+    CHECK(regs[9] == 3u);
+    CHECK(regs[13] == 4u);
+    CHECK(regs[16] == 0u);
+}
+
+TEST_CASE("write several fields of an element", "[reg_array]") {
+    reset();
+    groov::sync_write(grp("CH"_r[2]("en"_f = 1, "count"_f = 7)));
+    CHECK(regs[9] == 0x0000'0701u);
+    CHECK(iface::num_stores == 1);
+}
+
+TEST_CASE("several paths indexed to the same element", "[reg_array]") {
+    reset();
+    auto const i = std::size_t{2};
+    groov::sync_write(grp("CH.en"_f[i] = 1, "CH.count"_f[i] = 7));
+    CHECK(regs[9] == 0x0000'0701u);
+    CHECK(iface::num_stores == 1);
+}
+
+TEST_CASE("an element and a plain register in one spec", "[reg_array]") {
+    reset();
+    groov::sync_write(grp("CH.en"_f[1] = 1, "global"_r = 5));
+    CHECK(regs[5] == 1u);
+    CHECK(regs[16] == 5u);
+}
+
+TEST_CASE("a read spec remembers its element", "[reg_array]") {
+    reset();
+    regs[9] = 0x0000'0100u;
+    auto spec = groov::sync_read(grp / "CH"_r[2]);
+    spec["CH.count"_f] += 1;
+    groov::sync_write(spec);
+    CHECK(regs[9] == 0x0000'0200u);
+    CHECK(regs[1] == 0u);
+}
+
+TEST_CASE("lazy read of an element of a register array", "[reg_array]") {
+    reset();
+    regs[9] = 0x0000'0a00u;
+    auto spec = groov::lazy_read(grp / "CH"_r[2]);
+    CHECK(spec["CH.count"_f] == 0x0au);
+}
+
+TEST_CASE("only a spec with a register array holds an index",
+          "[reg_array]") {
+    STATIC_CHECK(std::is_empty_v<decltype(grp / "global"_r)>);
+    STATIC_CHECK(sizeof(grp("global"_r = 1u)) == sizeof(std::uint32_t));
+    STATIC_CHECK(not std::is_empty_v<decltype(grp / "CH"_r[0])>);
+}
+
+TEST_CASE("modify an element of a register array", "[reg_array]") {
+    reset();
+    regs[13] = 0x0000'0a41u;
+    CHECK(groov::modify(grp("CH.mode"_f[3]),
+                        [](auto &spec) { spec["CH.mode"_f] += 1; }) |
+          async::sync_wait());
+    CHECK(regs[13] == 0x0000'0a43u);
+    CHECK(iface::num_loads == 1);
+    CHECK(iface::num_stores == 1);
+}
@@ -0,0 +1,185 @@
+#include <groov/config.hpp>
+#include <groov/identity.hpp>
+#include <groov/mmio_bus.hpp>
+#include <groov/path.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/shadow.hpp>
+#include <groov/value_path.hpp>
+#include <groov/write.hpp>
+#include <groov/write_spec.hpp>
+
+#include <async/concepts.hpp>
+#include <async/sync_wait.hpp>
+
+#include <stdx/bit.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+using namespace groov::literals;
+
+namespace {
+alignas(std::uint64_t) std::array<std::uint32_t, 4> regs{};
+
+struct iface {
+    static inline std::size_t num_stores{};
+    static inline std::size_t num_loads{};
+
+    static auto to_mem(std::uintptr_t addr) -> std::uintptr_t {
+        return stdx::bit_cast<std::uintptr_t>(regs.data()) + addr;
+    }
+
+    template <std::unsigned_integral T> static auto store(std::uintptr_t addr) {
+        ++num_stores;
+        return groov::cpp_mem_iface::template store<T>(to_mem(addr));
+    }
+
+    template <std::unsigned_integral T>
+    static auto load(std::uintptr_t addr) -> async::sender auto {
+        ++num_loads;
+        return groov::cpp_mem_iface::template load<T>(to_mem(addr));
+    }
+
+    template <typename T>
+    constexpr static std::size_t alignment =
+        groov::cpp_mem_iface::template alignment<T>;
+};
+
+using F_en = groov::field<"en", std::uint8_t, 0, 0>;
+using F_mode = groov::field<"mode", std::uint8_t, 7, 4>;
+using F_status = groov::field<"status", std::uint8_t, 31, 31,
+                              groov::w::one_to_clear>;
+
+using R_ctrl = groov::reg<"ctrl", std::uint32_t, 0x0u, groov::w::replace,
+                          groov::attr::shadowed, F_en, F_mode, F_status>;
+using R_cfg = groov::reg<"cfg", std::uint32_t, 0x4u, groov::w::replace, F_en>;
+
+using F_lo = groov::field<"lo", std::uint8_t, 3, 0>;
+using F_hi = groov::field<"hi", std::uint32_t, 31, 4>;
+using R_div = groov::reg<"div", std::uint32_t, 0x8u, groov::w::replace,
+                         groov::attr::shadowed, F_lo, F_hi>;
+
+using R_next = groov::reg<"next", std::uint32_t, 0xcu>;
+
+using G = groov::group<"group", groov::mmio_bus<iface>, R_ctrl, R_cfg, R_div,
+                       R_next>;
+constexpr auto grp = G{};
+
+struct coalescing_iface : iface {
+    using coalesce_t = std::uint64_t;
+};
+using G_coalesce = groov::group<"group", groov::mmio_bus<coalescing_iface>,
+                                R_div, R_next>;
+constexpr auto grp_coalesce = G_coalesce{};
+
+auto reset() {
+    regs = {};
+    iface::num_stores = {};
+    iface::num_loads = {};
+    groov::invalidate(grp("ctrl"_r, "div"_r));
+    groov::invalidate(grp_coalesce("div"_r));
+}
+} // namespace
+
+TEST_CASE("register attributes", "[shadow]") {
+    STATIC_CHECK(groov::has_attribute<R_ctrl, groov::attr::shadowed>);
+    STATIC_CHECK(not groov::has_attribute<R_cfg, groov::attr::shadowed>);
+    STATIC_CHECK(not groov::has_attribute<F_en, groov::attr::shadowed>);
+    STATIC_CHECK(std::is_same_v<groov::get_child<R_ctrl, "en">, F_en>);
+}
+
+TEST_CASE("partial write without a valid shadow incurs RMW", "[shadow]") {
+    reset();
+    regs[0] = 0xa0u;
+
+    CHECK(sync_write(grp("ctrl.en"_f = 1u)));
+    CHECK(iface::num_loads == 1);
+    CHECK(iface::num_stores == 1);
+    CHECK(regs[0] == 0xa1u);
+
+    CHECK(sync_write(grp("ctrl.en"_f = 0u)));
+    CHECK(iface::num_loads == 2);
+}
+
+TEST_CASE("partial write after resync is served from the shadow", "[shadow]") {
+    reset();
+    regs[0] = 0xa0u;
+
+    CHECK(groov::resync(grp("ctrl"_r)) | async::sync_wait());
+    CHECK(iface::num_loads == 1);
+
+    CHECK(sync_write(grp("ctrl.en"_f = 1u)));
+    CHECK(sync_write(grp("ctrl.mode"_f = 5u)));
+    CHECK(iface::num_loads == 1);
+    CHECK(iface::num_stores == 2);
+    CHECK(regs[0] == 0x51u);
+}
+
+TEST_CASE("whole register write makes the shadow valid", "[shadow]") {
+    reset();
+
+    CHECK(sync_write(grp("div"_r = 0x30u)));
+    CHECK(sync_write(grp("div.lo"_f = 1u)));
+    CHECK(iface::num_loads == 0);
+    CHECK(iface::num_stores == 2);
+    CHECK(regs[2] == 0x31u);
+}
+
+TEST_CASE("writes from the shadow use identity values", "[shadow]") {
+    reset();
+    regs[0] = 0x8000'0000u;
+
+    CHECK(groov::resync(grp("ctrl"_r)) | async::sync_wait());
+    CHECK(sync_write(grp("ctrl.en"_f = 1u)));
+    CHECK(iface::num_loads == 1);
+    CHECK(regs[0] == 0x1u);
+}
+
+TEST_CASE("a write uses the shadow as it is when the write starts",
+          "[shadow]") {
+    reset();
+    auto whole = groov::write(grp("div"_r = 0x30u));
+    auto partial = groov::write(grp("div.lo"_f = 1u));
+
+    CHECK(whole | async::sync_wait());
+    CHECK(partial | async::sync_wait());
+    CHECK(iface::num_loads == 0);
+    CHECK(regs[2] == 0x31u);
+}
+
+TEST_CASE("invalidate makes writes read the register again", "[shadow]") {
+    reset();
+
+    CHECK(groov::resync(grp("ctrl"_r)) | async::sync_wait());
+    regs[0] = 0x40u;
+    groov::invalidate(grp("ctrl"_r));
+
+    CHECK(sync_write(grp("ctrl.en"_f = 1u)));
+    CHECK(iface::num_loads == 2);
+    CHECK(regs[0] == 0x41u);
+}
+
+TEST_CASE("registers without the attribute are not shadowed", "[shadow]") {
+    reset();
+    regs[1] = 0x30u;
+
+    CHECK(sync_write(grp("cfg.en"_f = 1u)));
+    CHECK(iface::num_loads == 1);
+    CHECK(regs[1] == 0x31u);
+}
+
+TEST_CASE("coalesced writes keep the shadow up to date", "[shadow]") {
+    reset();
+
+    CHECK(sync_write(grp_coalesce("div"_r = 0x30u, "next"_r = 1u)));
+    CHECK(iface::num_stores == 1);
+
+    CHECK(sync_write(grp_coalesce("div.lo"_f = 1u)));
+    CHECK(iface::num_loads == 0);
+    CHECK(regs[2] == 0x31u);
+    CHECK(regs[3] == 1u);
+}
@@ -0,0 +1,145 @@
+#include <groov/config.hpp>
+#include <groov/path.hpp>
+#include <groov/read.hpp>
+#include <groov/sim_bus.hpp>
+#include <groov/test.hpp>
+#include <groov/value_path.hpp>
+#include <groov/write.hpp>
+#include <groov/write_spec.hpp>
+
+#include <async/sync_wait.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace groov::literals;
+using namespace std::chrono_literals;
+
+template <> constexpr auto groov::test::concurrent_store<"wide"> = true;
+
+namespace {
+using F_en = groov::field<"en", bool, 0, 0>;
+using F_pending = groov::field<"pending", bool, 1, 1, groov::w::one_to_clear>;
+using R_ctrl = groov::reg<"ctrl", std::uint32_t, 0x0u, groov::w::replace,
+                          F_en, F_pending>;
+using R_data = groov::reg<"data", std::uint32_t, 0x4u>;
+
+using bus_t = groov::test::sim_bus<"sim">;
+using G = groov::group<"sim", bus_t, R_ctrl, R_data>;
+constexpr auto grp = G{};
+
+using wide_bus_t = groov::test::sim_bus<"wide", 2>;
+using WG = groov::group<"wide", wide_bus_t, R_ctrl, R_data>;
+constexpr auto wgrp = WG{};
+
+auto elapsed_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::steady_clock::now() - start;
+}
+} // namespace
+
+TEST_CASE("uniform latency is within its bounds", "[sim_bus]") {
+    auto l = groov::test::uniform_latency{10us, 20us};
+    for (auto i = 0; i < 100; ++i) {
+        auto const d = l();
+        CHECK(d >= 10us);
+        CHECK(d <= 20us);
+    }
+}
+
+TEST_CASE("uniform latency is repeatable", "[sim_bus]") {
+    auto l1 = groov::test::uniform_latency{10us, 20us, 42};
+    auto l2 = groov::test::uniform_latency{10us, 20us, 42};
+    for (auto i = 0; i < 10; ++i) {
+        CHECK(l1() == l2());
+    }
+}
+
+TEST_CASE("sim bus reads and writes the test store", "[sim_bus]") {
+    groov::test::reset_store<G>();
+    bus_t::set_latency(groov::test::fixed_latency{});
+    groov::test::set_value<G>("ctrl"_r, 0x0000'0002u);
+
+    CHECK(groov::write(grp("data"_r = 42u)) | async::sync_wait());
+    CHECK(groov::write(grp("ctrl.pending"_f = true)) | async::sync_wait());
+    CHECK(groov::test::get_value<G>("data"_r) == 42u);
+    CHECK(groov::test::get_value<G>("ctrl"_r) == 0u);
+
+    auto r = groov::read(grp / "data"_r) | async::sync_wait();
+    REQUIRE(r);
+    auto v = get<0>(*r);
+    REQUIRE(v);
+    CHECK(*v == 42u);
+}
+
+TEST_CASE("sim bus transactions take their latency", "[sim_bus]") {
+    groov::test::reset_store<G>();
+    bus_t::set_latency(groov::test::fixed_latency{});
+    groov::test::set_latency<G>("data"_r, groov::test::fixed_latency{5ms});
+
+    auto const start = std::chrono::steady_clock::now();
+    CHECK(groov::write(grp("data"_r = 42u)) | async::sync_wait());
+    CHECK(elapsed_since(start) >= 5ms);
+
+    CHECK(groov::write(grp("ctrl"_r = 1u)) | async::sync_wait());
+
+    // back to the default
+    groov::test::set_latency(grp, "data"_r, {});
+}
+
+TEST_CASE("sim bus limits outstanding transactions", "[sim_bus]") {
+    groov::test::reset_store<G>();
+    bus_t::set_latency(groov::test::fixed_latency{5ms});
+    bus_t::reset_peak_outstanding();
+
+    auto const start = std::chrono::steady_clock::now();
+    CHECK(groov::write(grp("ctrl"_r = 1u, "data"_r = 2u)) | async::sync_wait());
+    // one at a time
+    CHECK(elapsed_since(start) >= 10ms);
+    CHECK(bus_t::peak_outstanding() <= 1);
+    CHECK(bus_t::outstanding() == 0);
+
+    bus_t::set_latency(groov::test::fixed_latency{});
+}
+
+TEST_CASE("sim bus allows several outstanding transactions", "[sim_bus]") {
+    groov::test::reset_store<WG>();
+    wide_bus_t::set_latency(groov::test::fixed_latency{2ms});
+    wide_bus_t::reset_peak_outstanding();
+
+    auto const start = std::chrono::steady_clock::now();
+    auto written = std::array<bool, 6>{};
+    auto threads = std::vector<std::thread>{};
+    for (auto t = 0u; t < 6u; ++t) {
+        threads.emplace_back([&written, t] {
+            written[t] = static_cast<bool>(groov::write(wgrp("data"_r = t)) |
+                                           async::sync_wait());
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    CHECK(written == std::array{true, true, true, true, true, true});
+    // two at a time
+    CHECK(elapsed_since(start) >= 6ms);
+    CHECK(wide_bus_t::peak_outstanding() <= 2);
+    CHECK(wide_bus_t::outstanding() == 0);
+    CHECK(groov::test::get_value<WG>("data"_r) < 6u);
+}
+
+TEST_CASE("sim bus store callbacks may set latencies", "[sim_bus]") {
+    groov::test::reset_store<G>();
+    bus_t::set_latency(groov::test::fixed_latency{});
+
+    auto written = std::uint32_t{};
+    groov::test::set_write_function<G>("data"_r, [&](auto, auto value) {
+        bus_t::set_latency<"data">(groov::test::fixed_latency{});
+        written = get<std::uint32_t>(value).value_or(0);
+    });
+    CHECK(groov::write(grp("data"_r = 42u)) | async::sync_wait());
+    CHECK(written == 42u);
+}
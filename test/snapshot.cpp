@@ -0,0 +1,113 @@
+#include <groov/config.hpp>
+#include <groov/constant.hpp>
+#include <groov/identity.hpp>
+#include <groov/mmio_bus.hpp>
+#include <groov/path.hpp>
+#include <groov/snapshot.hpp>
+
+#include <async/concepts.hpp>
+#include <async/sync_wait.hpp>
+
+#include <stdx/bit.hpp>
+
+#include <boost/mp11/list.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace groov::literals;
+
+namespace {
+alignas(std::uint64_t) std::array<std::uint32_t, 8> regs{};
+
+struct iface {
+    static inline std::vector<std::uintptr_t> stores{};
+    static inline std::size_t num_loads{};
+
+    static auto to_mem(std::uintptr_t addr) -> std::uintptr_t {
+        return stdx::bit_cast<std::uintptr_t>(regs.data()) + addr;
+    }
+
+    template <std::unsigned_integral T> static auto store(std::uintptr_t addr) {
+        stores.push_back(addr);
+        return groov::cpp_mem_iface::template store<T>(to_mem(addr));
+    }
+
+    template <std::unsigned_integral T>
+    static auto load(std::uintptr_t addr) -> async::sender auto {
+        ++num_loads;
+        return groov::cpp_mem_iface::template load<T>(to_mem(addr));
+    }
+
+    template <typename T>
+    constexpr static std::size_t alignment =
+        groov::cpp_mem_iface::template alignment<T>;
+
+    using coalesce_t = std::uint64_t;
+};
+
+using F_en = groov::field<"en", std::uint8_t, 0, 0>;
+using F_pending =
+    groov::field<"pending", std::uint8_t, 1, 1, groov::w::one_to_clear>;
+
+using R_load = groov::reg<"load", std::uint32_t, 0x0u>;
+using R_cmp = groov::reg<"cmp", std::uint32_t, 0x4u>;
+using R_id = groov::reg<"id", std::uint32_t, 0x8u,
+                        groov::read_only<groov::w::ignore>>;
+using R_cmd = groov::reg<"cmd", std::uint32_t, 0xcu,
+                         groov::write_only<groov::w::replace>>;
+using R_intr = groov::reg<"intr", std::uint32_t, 0x10u, groov::w::replace,
+                          F_en, F_pending>;
+using R_fifo =
+    groov::reg<"fifo", std::uint32_t, 0x14u, groov::r::pop<groov::w::replace>>;
+using R_version = groov::reg<"version", std::uint32_t, 0x18u,
+                             groov::w::replace, groov::attr::constant>;
+using R_mask = groov::reg<"mask", std::uint32_t, 0x1cu>;
+
+using G = groov::group<"timer", groov::mmio_bus<iface>, R_mask, R_load, R_cmp,
+                       R_id, R_cmd, R_intr, R_fifo, R_version>;
+constexpr auto grp = G{};
+} // namespace
+
+TEST_CASE("a snapshot holds only registers that can be restored",
+          "[snapshot]") {
+    using paths_t = typename groov::detail::snapshot_spec_t<G>::paths_t;
+    STATIC_CHECK(std::same_as<paths_t, boost::mp11::mp_list<
+                                           groov::path<"mask">,
+                                           groov::path<"load">,
+                                           groov::path<"cmp">,
+                                           groov::path<"intr", "en">>>);
+    STATIC_CHECK(sizeof(groov::snapshot_t<G>) <=
+                 5 * sizeof(std::uint32_t) + sizeof(std::size_t));
+}
+
+TEST_CASE("snapshot reads the saved registers", "[snapshot]") {
+    regs = {1u, 2u, 3u, 4u, 0x3u, 6u, 7u, 8u};
+    iface::num_loads = 0;
+
+    auto s = get<0>(*(groov::snapshot(grp) | async::sync_wait()));
+    CHECK(s["load"_r] == 1u);
+    CHECK(s["cmp"_r] == 2u);
+    CHECK(s["intr.en"_f] == 1u);
+    CHECK(s["mask"_r] == 8u);
+    // load and cmp are read together
+    CHECK(iface::num_loads == 3);
+}
+
+TEST_CASE("restore writes the snapshot back", "[snapshot]") {
+    regs = {1u, 2u, 3u, 4u, 0x1u, 6u, 7u, 8u};
+    auto s = get<0>(*(groov::snapshot(grp) | async::sync_wait()));
+
+    regs = {};
+    iface::stores.clear();
+    CHECK(groov::restore(grp, s) | async::sync_wait());
+    CHECK(regs == std::array<std::uint32_t, 8>{1u, 2u, 0u, 0u, 1u, 0u, 0u,
+                                               8u});
+    // in declared order, with load and cmp written together
+    CHECK(iface::stores == std::vector<std::uintptr_t>{0x1cu, 0x0u, 0x10u});
+}
@@ -0,0 +1,129 @@
+#include <groov/config.hpp>
+#include <groov/path.hpp>
+#include <groov/read.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/tear_free.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just_result_of.hpp>
+#include <async/sync_wait.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace groov::literals;
+
+namespace {
+// a 64-bit counter that ticks on every bus access
+std::uint64_t counter{};
+std::uint64_t latched{};
+std::size_t num_reads{};
+
+enum : std::uint32_t {
+    live_lo = 0x0,
+    live_hi = 0x4,
+    latching_lo = 0x10,
+    latched_hi = 0x14,
+    holding_lo = 0x20,
+    holding_hi = 0x24,
+    latch = 0x28,
+};
+
+struct bus {
+    template <stdx::ct_string, auto>
+    static auto read(std::uint32_t addr) -> async::sender auto {
+        return async::just_result_of([=]() -> std::uint32_t {
+            ++num_reads;
+            auto const now = counter++;
+            switch (addr) {
+            case live_lo:
+                return static_cast<std::uint32_t>(now);
+            case live_hi:
+                return static_cast<std::uint32_t>(now >> 32u);
+            case latching_lo:
+                latched = now;
+                return static_cast<std::uint32_t>(now);
+            case holding_lo:
+                return static_cast<std::uint32_t>(latched);
+            default:
+                return static_cast<std::uint32_t>(latched >> 32u);
+            }
+        });
+    }
+
+    template <stdx::ct_string, auto, auto, auto>
+    static auto write(std::uint32_t addr, std::uint32_t value)
+        -> async::sender auto {
+        return async::just_result_of([=] {
+            if (addr == latch and value == 1) {
+                latched = counter++;
+            }
+        });
+    }
+};
+
+using R_lo = groov::reg<"lo", std::uint32_t, std::uint32_t{live_lo},
+                        groov::w::replace, groov::attr::high_word<"hi">>;
+using R_hi = groov::reg<"hi", std::uint32_t, std::uint32_t{live_hi}>;
+
+using R_latching_lo =
+    groov::reg<"latching_lo", std::uint32_t, std::uint32_t{latching_lo},
+               groov::w::replace,
+               groov::attr::high_word<"latched_hi", groov::lo_latches_hi>>;
+using R_latched_hi =
+    groov::reg<"latched_hi", std::uint32_t, std::uint32_t{latched_hi}>;
+
+using F_snap = groov::field<"snap", std::uint8_t, 0, 0>;
+using R_ctrl = groov::reg<"ctrl", std::uint32_t, std::uint32_t{latch},
+                          groov::w::replace, F_snap>;
+using R_holding_lo = groov::reg<
+    "holding_lo", std::uint32_t, std::uint32_t{holding_lo}, groov::w::replace,
+    groov::attr::high_word<"holding_hi", groov::latch_strobe<"ctrl.snap">>>;
+using R_holding_hi =
+    groov::reg<"holding_hi", std::uint32_t, std::uint32_t{holding_hi}>;
+
+using G = groov::group<"group", bus, R_lo, R_hi, R_latching_lo, R_latched_hi,
+                       R_ctrl, R_holding_lo, R_holding_hi>;
+constexpr auto grp = G{};
+
+auto reset(std::uint64_t start) {
+    counter = start;
+    latched = {};
+    num_reads = {};
+}
+} // namespace
+
+TEST_CASE("hi-lo-hi read of a pair that does not carry", "[tear_free]") {
+    reset(0x1'0000'0000u);
+    auto r = groov::read_tear_free(grp / "lo"_r) | async::sync_wait();
+    REQUIRE(r);
+    CHECK(get<0>(*r) == 0x1'0000'0001u);
+    CHECK(num_reads == 3);
+}
+
+TEST_CASE("hi-lo-hi read retries across a carry", "[tear_free]") {
+    // hi is read as 0, then lo as 0 after the carry: a torn 0x0
+    reset(0xffff'ffffu);
+    auto r = groov::read_tear_free(grp / "lo"_r) | async::sync_wait();
+    REQUIRE(r);
+    CHECK(get<0>(*r) == 0x1'0000'0003u);
+    CHECK(num_reads == 6);
+}
+
+TEST_CASE("lo-latches-hi read", "[tear_free]") {
+    reset(0xffff'ffffu);
+    auto r = groov::read_tear_free(grp / "latching_lo"_r) | async::sync_wait();
+    REQUIRE(r);
+    CHECK(get<0>(*r) == 0xffff'ffffu);
+    CHECK(num_reads == 2);
+}
+
+TEST_CASE("latch-strobe read", "[tear_free]") {
+    reset(0xffff'ffffu);
+    auto r = groov::read_tear_free(grp / "holding_lo"_r) | async::sync_wait();
+    REQUIRE(r);
+    CHECK(get<0>(*r) == 0xffff'ffffu);
+    CHECK(num_reads == 2);
+}
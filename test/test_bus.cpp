@@ -9,8 +9,16 @@
 #include <async/sync_wait.hpp>
 #include <async/then.hpp>
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+template <> constexpr auto groov::test::concurrent_store<"concurrent"> = true;
+
 TEST_CASE("value get (correct type)", "[test_bus]") {
     groov::test::detail::value v{42};
     auto o = v.get<int>();
@@ -73,6 +81,17 @@ TEST_CASE("test bus write and read back", "[test_bus]") {
     CHECK(*opt_val == 42);
 }
 
+TEST_CASE("test bus write replaces the bits under the mask", "[test_bus]") {
+    groov::test::store<"test">::reset();
+    groov::test::store<"test">::set_value(0x10, 0xffu);
+    groov::test::bus<"test"> b{};
+    REQUIRE(b.write<"", 0xffu, 0u, 0u>(0x10, 0x0fu) | async::sync_wait());
+    CHECK(groov::test::store<"test">::get_value<unsigned>(0x10) == 0x0fu);
+
+    REQUIRE(b.write<"", 0xf0u, 0u, 0u>(0x10, 0x30u) | async::sync_wait());
+    CHECK(groov::test::store<"test">::get_value<unsigned>(0x10) == 0x3fu);
+}
+
 namespace {
 using R = groov::reg<"reg", std::uint32_t, 0xcafe, groov::w::replace>;
 using G = groov::group<"group", groov::test::bus<"test">, R>;
@@ -109,3 +128,260 @@ TEST_CASE("read-modify-write", "[test_bus]") {
     REQUIRE(r);
     CHECK((*r)["reg"_r] == 0x5a5a'5a5au);
 }
+
+namespace {
+using F_en = groov::field<"en", bool, 0, 0>;
+using F_pending = groov::field<"pending", bool, 1, 1, groov::w::one_to_clear>;
+using F_start = groov::field<"start", bool, 2, 2, groov::w::one_to_set>;
+using F_ack = groov::field<"ack", bool, 3, 3, groov::w::zero_to_clear>;
+using F_id = groov::field<"id", std::uint8_t, 15, 8,
+                          groov::read_only<groov::w::ignore>>;
+using R_intr = groov::reg<"intr", std::uint32_t, 0xbeef, groov::w::replace,
+                          F_en, F_pending, F_start, F_ack, F_id>;
+using MG = groov::group<"model", groov::test::bus<"model">, R_intr>;
+constexpr auto mgrp = MG{};
+} // namespace
+
+TEST_CASE("test bus models one_to_clear fields", "[test_bus]") {
+    using namespace groov::literals;
+    groov::test::reset_store<MG>();
+    groov::test::set_value<MG>("intr"_r, 0x0000'0002u);
+
+    CHECK(sync_write(mgrp("intr.en"_f = true)));
+    CHECK(groov::test::get_value<MG>("intr"_r) == 0x0000'0003u);
+    CHECK(sync_write(mgrp("intr.pending"_f = true)));
+    CHECK(groov::test::get_value<MG>("intr"_r) == 0x0000'0001u);
+}
+
+TEST_CASE("test bus models one_to_set and zero_to_clear fields",
+          "[test_bus]") {
+    using namespace groov::literals;
+    groov::test::reset_store<MG>();
+    groov::test::set_value<MG>("intr"_r, 0x0000'0008u);
+
+    CHECK(sync_write(mgrp("intr.start"_f = true)));
+    CHECK(groov::test::get_value<MG>("intr"_r) == 0x0000'000cu);
+    CHECK(sync_write(mgrp("intr.start"_f = false, "intr.ack"_f = false)));
+    CHECK(groov::test::get_value<MG>("intr"_r) == 0x0000'0004u);
+}
+
+TEST_CASE("test bus does not change read-only fields", "[test_bus]") {
+    using namespace groov::literals;
+    groov::test::reset_store<MG>();
+    groov::test::set_value<MG>("intr"_r, 0x0000'4200u);
+
+    CHECK(sync_write(mgrp("intr.en"_f = true)));
+    CHECK(groov::test::get_value<MG>("intr"_r) == 0x0000'4201u);
+}
+
+TEST_CASE("test bus passes written bits to a write function", "[test_bus]") {
+    using namespace groov::literals;
+    groov::test::reset_store<MG>();
+    groov::test::set_value<MG>("intr"_r, 0x0000'0003u);
+    auto written = std::uint32_t{};
+    groov::test::set_write_function<MG>("intr"_r, [&](auto, auto value) {
+        written = get<std::uint32_t>(value).value_or(0);
+    });
+
+    CHECK(sync_write(mgrp("intr.pending"_f = true)));
+    // ack is written with its identity value
+    CHECK(written == 0x0000'000bu);
+    CHECK(groov::test::get_value<MG>("intr"_r) == 0x0000'0003u);
+}
+
+TEST_CASE("test store treats addresses of any integral type alike",
+          "[test_bus]") {
+    using S = groov::test::store<"test">;
+    S::reset();
+    S::set_value(0x10, 42u);
+    CHECK(S::get_value<unsigned>(std::uintptr_t{0x10}) == 42u);
+    CHECK(not S::get_value<unsigned>(0x14));
+}
+
+TEST_CASE("test store keeps the type of a value", "[test_bus]") {
+    using S = groov::test::store<"test">;
+    S::reset();
+    S::set_value(0x10, std::uint32_t{42});
+    CHECK(S::get_value<std::uint32_t>(0x10) == 42u);
+    CHECK(not S::get_value<std::uint16_t>(0x10));
+}
+
+TEST_CASE("test store holds many addresses", "[test_bus]") {
+    using S = groov::test::store<"test">;
+    S::reset();
+    for (auto i = 0u; i < 1000u; ++i) {
+        S::set_value(i * 4u, i);
+    }
+    for (auto i = 0u; i < 1000u; ++i) {
+        CHECK(S::get_value<unsigned>(i * 4u) == i);
+    }
+    S::reset();
+    CHECK(not S::get_value<unsigned>(0u));
+    CHECK(not S::get_value<unsigned>(3996u));
+}
+
+TEST_CASE("isolated test store", "[test_bus]") {
+    using S = groov::test::store<G::name>;
+    S::reset();
+    S::set_value(0x10, 42u);
+    {
+        auto guard = groov::test::isolated_store<G>{};
+        CHECK(not S::get_value<unsigned>(0x10));
+        S::set_value(0x10, 17u);
+        CHECK(S::get_value<unsigned>(0x10) == 17u);
+    }
+    CHECK(S::get_value<unsigned>(0x10) == 42u);
+}
+
+TEST_CASE("isolated test store is per thread", "[test_bus]") {
+    using S = groov::test::store<G::name>;
+    S::reset();
+    S::set_value(0x10, 42u);
+
+    auto seen = std::array<bool, 4>{};
+    auto threads = std::vector<std::thread>{};
+    for (auto t = 0u; t < 4u; ++t) {
+        threads.emplace_back([&seen, t] {
+            auto guard = groov::test::isolated_store{grp};
+            S::set_value(0x10, t);
+            seen[t] = S::get_value<unsigned>(0x10) == t;
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    CHECK(seen == std::array{true, true, true, true});
+    CHECK(S::get_value<unsigned>(0x10) == 42u);
+}
+
+TEST_CASE("concurrent test store", "[test_bus]") {
+    using S = groov::test::store<"concurrent">;
+    S::reset();
+
+    constexpr auto num_threads = 8u;
+    constexpr auto per_thread = 1000u;
+    auto threads = std::vector<std::thread>{};
+    for (auto t = 0u; t < num_threads; ++t) {
+        threads.emplace_back([t] {
+            for (auto i = 0u; i < per_thread; ++i) {
+                auto const addr = (t * per_thread + i) * 4u;
+                S::set_value(addr, addr);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    auto correct = 0u;
+    for (auto a = 0u; a < num_threads * per_thread; ++a) {
+        correct += S::get_value<unsigned>(a * 4u) == a * 4u ? 1u : 0u;
+    }
+    CHECK(correct == num_threads * per_thread);
+}
+
+TEST_CASE("test store rollback restores a checkpoint", "[test_bus]") {
+    using S = groov::test::store<G::name>;
+    groov::test::reset_store<G>();
+    for (auto i = 0u; i < 100u; ++i) {
+        S::set_value(i * 4u, i);
+    }
+    auto const cp = groov::test::checkpoint(grp);
+
+    S::set_value(0u, 42u);
+    S::set_value(0u, 17u);
+    S::set_value(400u, 100u);
+    groov::test::rollback(cp);
+
+    CHECK(S::get_value<unsigned>(0u) == 0u);
+    CHECK(not S::get_value<unsigned>(400u));
+    auto correct = 0u;
+    for (auto i = 0u; i < 100u; ++i) {
+        correct += S::get_value<unsigned>(i * 4u) == i ? 1u : 0u;
+    }
+    CHECK(correct == 100u);
+}
+
+TEST_CASE("test store can roll back to a checkpoint repeatedly",
+          "[test_bus]") {
+    using S = groov::test::store<G::name>;
+    groov::test::reset_store<G>();
+    S::set_value(0u, 1u);
+    auto const cp = groov::test::checkpoint<G>();
+
+    for (auto i = 0u; i < 3u; ++i) {
+        CHECK(S::get_value<unsigned>(0u) == 1u);
+        S::set_value(0u, 2u + i);
+        groov::test::rollback(cp);
+    }
+    CHECK(S::get_value<unsigned>(0u) == 1u);
+}
+
+TEST_CASE("test store rollback of entries added since a checkpoint",
+          "[test_bus]") {
+    using S = groov::test::store<G::name>;
+    groov::test::reset_store<G>();
+    auto const cp = groov::test::checkpoint<G>();
+    for (auto i = 0u; i < 1000u; ++i) {
+        S::set_value(i * 4u, i);
+    }
+    groov::test::rollback(cp);
+    auto present = 0u;
+    for (auto i = 0u; i < 1000u; ++i) {
+        present += S::get_value<unsigned>(i * 4u) ? 1u : 0u;
+    }
+    CHECK(present == 0u);
+    S::set_value(8u, 3u);
+    CHECK(S::get_value<unsigned>(8u) == 3u);
+}
+
+TEST_CASE("test store nested checkpoints", "[test_bus]") {
+    using S = groov::test::store<G::name>;
+    groov::test::reset_store<G>();
+    S::set_value(0u, 1u);
+    auto const outer = groov::test::checkpoint<G>();
+    S::set_value(0u, 2u);
+    S::set_value(4u, 2u);
+    auto const inner = groov::test::checkpoint<G>();
+    S::set_value(0u, 3u);
+    S::set_value(8u, 3u);
+
+    groov::test::rollback(inner);
+    CHECK(S::get_value<unsigned>(0u) == 2u);
+    CHECK(S::get_value<unsigned>(4u) == 2u);
+    CHECK(not S::get_value<unsigned>(8u));
+
+    groov::test::rollback(outer);
+    CHECK(S::get_value<unsigned>(0u) == 1u);
+    CHECK(not S::get_value<unsigned>(4u));
+}
+
+TEST_CASE("test store checkpoint under an isolated store", "[test_bus]") {
+    using S = groov::test::store<G::name>;
+    groov::test::reset_store<G>();
+    S::set_value(0u, 1u);
+    auto const outer = groov::test::checkpoint<G>();
+    {
+        auto guard = groov::test::isolated_store<G>{};
+        S::set_value(0u, 2u);
+        auto const cp = groov::test::checkpoint<G>();
+        S::set_value(0u, 3u);
+        groov::test::rollback(cp);
+        CHECK(S::get_value<unsigned>(0u) == 2u);
+    }
+    CHECK(S::get_value<unsigned>(0u) == 1u);
+
+    // the guard's checkpoint did not disturb the group's own store
+    S::set_value(0u, 4u);
+    groov::test::rollback(outer);
+    CHECK(S::get_value<unsigned>(0u) == 1u);
+}
+
+TEST_CASE("test bus operations", "[.][benchmark]") {
+    using namespace groov::literals;
+    groov::test::store<"test">::reset();
+    auto i = 0u;
+    BENCHMARK("write") {
+        return sync_write(grp("reg"_r = ++i));
+    };
+    BENCHMARK("read") { return sync_read(grp / "reg"_r); };
+}
@@ -0,0 +1,156 @@
+#include <groov/config.hpp>
+#include <groov/mmio_bus.hpp>
+#include <groov/path.hpp>
+#include <groov/read_spec.hpp>
+#include <groov/wait_until.hpp>
+
+#include <async/concepts.hpp>
+#include <async/just.hpp>
+#include <async/schedulers/thread_scheduler.hpp>
+#include <async/sync_wait.hpp>
+
+#include <stdx/bit.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+using namespace groov::literals;
+
+namespace {
+std::array<std::uint32_t, 2> regs{};
+std::array<std::size_t, 2> loads{};
+
+// the status register becomes ready after a number of loads
+std::size_t ready_after{};
+
+struct iface {
+    template <std::unsigned_integral T> static auto store(std::uintptr_t addr) {
+        return groov::cpp_mem_iface::template store<T>(
+            stdx::bit_cast<std::uintptr_t>(&regs[addr / 4]));
+    }
+
+    template <std::unsigned_integral T>
+    static auto load(std::uintptr_t addr) -> async::sender auto {
+        if (++loads[addr / 4] >= ready_after and addr == 0) {
+            regs[0] |= 1u;
+        }
+        return groov::cpp_mem_iface::template load<T>(
+            stdx::bit_cast<std::uintptr_t>(&regs[addr / 4]));
+    }
+
+    template <typename T>
+    constexpr static std::size_t alignment =
+        groov::cpp_mem_iface::template alignment<T>;
+};
+
+using F_ready = groov::field<"ready", std::uint8_t, 0, 0>;
+using F_code = groov::field<"code", std::uint8_t, 7, 4>;
+
+using R_status = groov::reg<"status", std::uint32_t, 0x0u, groov::w::replace,
+                            F_ready, F_code>;
+using R_data = groov::reg<"data", std::uint32_t, 0x4u>;
+
+using G = groov::group<"group", groov::mmio_bus<iface>, R_status, R_data>;
+constexpr auto grp = G{};
+
+auto reset(std::size_t n) {
+    regs = {0x50u, 0u};
+    loads = {};
+    ready_after = n;
+}
+
+constexpr auto is_ready = [](auto ready) { return ready == 1; };
+
+// a clock that advances one tick each time it is read
+struct fake_clock {
+    using rep = int;
+    using period = std::milli;
+    using duration = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<fake_clock>;
+    constexpr static bool is_steady = true;
+
+    static inline rep ticks{};
+    static auto now() -> time_point { return time_point{duration{ticks++}}; }
+};
+} // namespace
+
+TEST_CASE("wait_until re-reads until the predicate is satisfied",
+          "[wait_until]") {
+    reset(5);
+    auto r = groov::wait_until(grp / "status.ready"_f, is_ready) |
+             async::sync_wait();
+    REQUIRE(r);
+    CHECK(get<0>(*r) == 1);
+    CHECK(loads[0] == 5);
+}
+
+TEST_CASE("wait_until reads only the registers in its spec", "[wait_until]") {
+    reset(3);
+    auto r = groov::wait_until(grp / "status.ready"_f, is_ready) |
+             async::sync_wait();
+    CHECK(r);
+    CHECK(loads[1] == 0);
+}
+
+TEST_CASE("wait_until sends what satisfied the predicate", "[wait_until]") {
+    reset(2);
+    auto r = groov::wait_until(grp("status.ready"_f, "status.code"_f),
+                               [](auto const &spec) {
+                                   return spec["status.ready"_f] == 1;
+                               }) |
+             async::sync_wait();
+    REQUIRE(r);
+    CHECK(get<0>(*r)["status.code"_f] == 5);
+}
+
+TEST_CASE("wait_until can convert what it reads", "[wait_until]") {
+    reset(2);
+    auto r = groov::wait_until<std::uint32_t>(
+                 grp / "status"_r, [](std::uint32_t v) { return v & 1u; }) |
+             async::sync_wait();
+    REQUIRE(r);
+    CHECK(get<0>(*r) == 0x51u);
+}
+
+TEST_CASE("wait_until with exponential backoff", "[wait_until]") {
+    reset(4);
+    auto r = groov::wait_until(grp / "status.ready"_f, is_ready,
+                               groov::backoff<1, 8>{}) |
+             async::sync_wait();
+    CHECK(r);
+    CHECK(loads[0] == 4);
+}
+
+TEST_CASE("wait_until yielding to a scheduler", "[wait_until]") {
+    reset(3);
+    auto r = groov::wait_until(grp / "status.ready"_f, is_ready,
+                               groov::yield_to{async::thread_scheduler{}}) |
+             async::sync_wait();
+    CHECK(r);
+    CHECK(loads[0] == 3);
+}
+
+TEST_CASE("wait_until sends an error when its deadline passes",
+          "[wait_until]") {
+    reset(100);
+    fake_clock::ticks = 0;
+    auto const deadline = fake_clock::time_point{fake_clock::duration{10}};
+    auto r = groov::wait_until(grp / "status.ready"_f, is_ready, groov::spin{},
+                               deadline) |
+             async::sync_wait();
+    CHECK(not r);
+    CHECK(loads[0] == 11);
+}
+
+TEST_CASE("wait_until is pipeable", "[wait_until]") {
+    reset(2);
+    auto r = async::just(grp / "status.ready"_f) |
+             groov::wait_until(is_ready) | async::sync_wait();
+    CHECK(r);
+    CHECK(loads[0] == 2);
+}
@@ -14,6 +14,8 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <array>
+#include <bit>
+#include <concepts>
 #include <cstdint>
 
 namespace {
@@ -549,3 +551,112 @@ TEST_CASE("write a field in a register containing WO fields which won't be "
     CHECK(groov::write(grp_be("reg4.field0"_r = 1)) | async::sync_wait());
     CHECK(data3 == 42);
 }
+
+TEST_CASE("write with a no-RMW policy", "[write]") {
+    using namespace groov::literals;
+    data3 = 0;
+    CHECK(groov::write<groov::no_rmw>(grp_be("reg4.field0"_r = 1)) |
+          async::sync_wait());
+    CHECK(data3 == 42);
+}
+
+TEST_CASE("write with a no-RMW policy (piped)", "[write]") {
+    using namespace groov::literals;
+    data3 = 0;
+    auto r = async::just(grp_be("reg4.field0"_r = 1)) |
+             groov::write<groov::no_rmw>() | async::sync_wait();
+    CHECK(r);
+    CHECK(data3 == 42);
+}
+
+TEST_CASE("sync_write with a load budget", "[write]") {
+    using namespace groov::literals;
+    CHECK(groov::sync_write<groov::blocking, groov::max_loads<0>>(
+        grp_be("reg4.field0"_r = 1)));
+    CHECK(groov::sync_write<groov::non_blocking, groov::max_loads<1>>(
+        grp("reg0.field0"_f = 1)));
+}
+
+namespace {
+struct coalescing_bus {
+    static inline int num_writes{};
+    static inline std::uint64_t last_mask{};
+    static inline std::uint64_t last_value{};
+    static inline std::uintptr_t last_addr{};
+
+    template <std::unsigned_integral T>
+    consteval static auto can_coalesce(std::uintptr_t addr) -> bool {
+        return addr % sizeof(T) == 0;
+    }
+
+    template <stdx::ct_string, auto Mask, auto IdMask, auto IdValue>
+    static auto write(auto addr, auto value) -> async::sender auto {
+        return async::just_result_of([=] {
+            ++num_writes;
+            last_mask = Mask | IdMask;
+            last_value = value | IdValue;
+            last_addr = addr;
+        });
+    }
+
+    template <stdx::ct_string, auto>
+    static auto read(auto) -> async::sender auto {
+        return async::just_result_of([] { return 0u; });
+    }
+};
+
+using R_lo = groov::reg<"lo", std::uint16_t, 0x100u>;
+using R_hi = groov::reg<"hi", std::uint16_t, 0x102u>;
+using R_next = groov::reg<"next", std::uint16_t, 0x104u>;
+
+using G_coalesce =
+    groov::group<"group", coalescing_bus, R_lo, R_hi, R_next>;
+constexpr auto grp_coalesce = G_coalesce{};
+} // namespace
+
+TEST_CASE("writes to adjacent registers are coalesced by a capable bus",
+          "[write]") {
+    using namespace groov::literals;
+    coalescing_bus::num_writes = 0;
+    CHECK(sync_write(grp_coalesce("hi"_r = 0xcafeu, "lo"_r = 0xd00du)));
+    CHECK(coalescing_bus::num_writes == 1);
+    CHECK(coalescing_bus::last_addr == 0x100u);
+    CHECK(coalescing_bus::last_mask == 0xffff'ffffu);
+    if constexpr (std::endian::native == std::endian::little) {
+        CHECK(coalescing_bus::last_value == 0xcafe'd00du);
+    }
+}
+
+TEST_CASE("writes to unaligned adjacent registers are not coalesced",
+          "[write]") {
+    using namespace groov::literals;
+    coalescing_bus::num_writes = 0;
+    CHECK(sync_write(grp_coalesce("hi"_r = 0xcafeu, "next"_r = 0xd00du)));
+    CHECK(coalescing_bus::num_writes == 2);
+}
+
+namespace {
+using F_en = groov::field<"en", std::uint8_t, 3, 0>;
+using F_status =
+    groov::field<"status", std::uint8_t, 7, 4,
+                 groov::read_only<groov::r::clear_on_read<groov::w::ignore>>>;
+
+std::uint32_t data_status{};
+using R_status = groov::reg<"ctrl", std::uint32_t, &data_status,
+                            groov::w::ignore, F_en, F_status>;
+using G_status = groov::group<"group", bus, R_status>;
+constexpr auto grp_status = G_status{};
+} // namespace
+
+TEST_CASE("write beside a field with side effects on read needs no load",
+          "[write]") {
+    using namespace groov::literals;
+    STATIC_CHECK(groov::has_read_effects<R_status>);
+    STATIC_CHECK(groov::plan_of(grp_status("ctrl.en"_f = 5)).num_loads() == 0);
+
+    bus::num_reads = 0;
+    data_status = 0xa0u;
+    CHECK(sync_write(grp_status("ctrl.en"_f = 5)));
+    CHECK(bus::num_reads == 0);
+    CHECK(data_status == 0x5u);
+}